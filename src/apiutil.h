@@ -354,7 +354,7 @@ inline const std::string move_to_san(Position& pos, Move m, Notation n) {
     {
         StateInfo st;
         pos.do_move(m, st);
-        san += MoveList<LEGAL>(pos).size() ? "+" : "#";
+        san += pos.has_any_legal_move() ? "+" : "#";
         pos.undo_move(m);
     }
 
@@ -16,9 +16,12 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <istream>
+#include <map>
 #include <vector>
 
 #include "position.h"
@@ -91,24 +94,103 @@ const vector<string> Defaults = {
   "setoption name UCI_Chess960 value false"
 };
 
+// Positions searched by bench in addition to the start position of a variant
+const map<string, vector<string>> VariantDefaults = {
+  // Drop variants
+  { "crazyhouse", {
+    "r1bB1rk1/ppp2ppp/2n1p3/8/2BPnP2/N3P3/PP1B2PP/R2Q2KR[QPPn] b - - 0 11",
+    "r1br2k1/ppp2ppp/2n1p3/7q/2BP1P2/N3PB1n/PP1Q2PP/R4K1R[BNPP] b - - 1 18",
+    "r2qkbnr/2Nb2pp/p1Qppp2/1p6/4PB2/2N5/PPP2PPP/R3KBNR[Pp] b KQkq - 0 9",
+    "rn2kb1r/pbpq2pp/1p2np2/1B1pB3/6QP/1P6/P1PP1PP1/R3K1NR[Pnp] b KQkq - 1 12"
+  }},
+
+  // Shogi-like variants
+  { "shogi", {
+    "lnsgkgsnl/5r3/pppppp1Pp/5BpR1/9/2P6/PPNPPPP1P/3S5/L2GKGSNL[Bp] b - - 0 11",
+    "lnsg1r1+Bl/3kg4/pppppS1+Rp/5pp2/9/2P6/PPNPP+bP1P/3SG4/L2GK1SNL[Nppp] b - - 2 18",
+    "lnsk2snl/1r2gg1b1/p1p1pp1pp/1p1p2p2/9/P1PB1P3/1PSPP1PPP/L4RS2/1N1GKG1NL[] b - - 17 9",
+    "1n1k3nl/lr1sggs2/2plpp1pp/pp7/2PN5/P2SBP3/1P1PP1PPP/L1R3S+b1/3GKG1N1[PP] b - - 6 20"
+  }},
+  { "minishogi", {
+    "1r2k/2sbp/B1G2/P1S1g/KR3[] b - - 7 11",
+    "3gk/4p/B4/P1K1g/2B1r[SSr] b - - 0 18",
+    "1s1gk/3s1/4+B/PGB2/1K2R[PR] b - - 0 9",
+    "r3k/1g2p/P2Bb/2SS1/1GK2[R] b - - 0 10"
+  }},
+
+  // Xiangqi and janggi
+  { "xiangqi", {
+    "r2akabr1/1C1n3C1/3cb1n2/2p1p1p1p/p8/9/P1PcP1P1P/1RN3N2/9/2BAKABR1 b - - 21 11",
+    "3akabr1/1r7/3Rbn1C1/2p1p3p/p5p2/9/P1P1P3P/2N3N2/9/2BAKAR2 b - - 0 18",
+    "4kabn1/4a3r/bcn4c1/p3p1CR1/2p5p/9/P1PrP1P1P/2N3N1C/4A4/R1BAK1B2 b - - 2 9",
+    "4ka3/4a3r/b1c4Rb/4pCn2/1np6/6C2/4P1P1P/4B1N2/4A4/3AK1B2 b - - 2 20"
+  }},
+  { "janggi", {
+    "2ba1ab1r/4k4/r1n1c1nc1/3ppp1C1/p8/2RN2C2/P2PP1PP1/9/4KA3/R1BA2BN1 b - - 2 11",
+    "2ba4r/4k4/r1n1ca3/3ppp2b/1p5n1/2R2cC2/P2PPNPPB/7C1/3KAA3/1RB4N1 b - - 16 18",
+    "r1ba1abnr/3k5/c1n4c1/1p2p1pp1/2P6/1P6P/5PP2/1C2C1N1R/4K4/RNBA1AB2 b - - 12 9",
+    "2ba2bnr/3ka4/r1nc3c1/3p2pp1/1p7/P1R5P/5PP2/1CN1C1N1R/4K4/2BA1A3 b - - 9 20"
+  }},
+
+  // Large-board variants
+  { "capablanca", {
+    "1nabqkb1nr/r5pppp/1p1cpp4/p1pp6/2PPPPP3/5N1P2/PP1N4PP/R1ABQKBC1R b KQk - 0 11",
+    "1nabqkb1nr/3cr1pp2/1p3p2pp/p2p1N4/2P2PP3/1P3BQP2/P2N4PP/R1A2KBC1R b KQk - 0 18",
+    "r2bqk3r/pppp2pppp/2nab1Bn2/4p5/2P1pP4/N2P3C2/PP4PPPP/R1A1QKB1NR b KQkq - 0 9",
+    "r3q4r/ppP3pkpp/2np2p3/10/2P3Q3/3A3P2/PP5P1P/R4KB3 b Q - 0 20"
+  }},
+  { "grand", {
+    "r1r7/1n1qk1ab2/2pp1pp1pp/b3p1cp1n/pp8/2PPPP4/P5P3/1P1N3PPP/2BQ1CABN1/R1K6R b - - 0 11",
+    "1rr7/1n1qk1ab2/2ppcp1n1p/b3p2pp1/p9/P1PPPP4/4A5/3N2NPPP/2BQ1C1B2/1RK6R b - - 0 18",
+    "r8r/2bqknabn1/pppApp1ppp/6p3/10/4PP4/6P3/PPPC3PPP/1NB1K2BN1/R2Q5R b - - 0 9",
+    "3r6/2q1knabn1/1p2pp2p1/p1p1b1p3/7p1p/4PP3P/2P2BPP2/1P1N3CP1/2B1K1Q1N1/9R b - - 0 20"
+  }},
+
+  // Blast variants
+  { "atomic", {
+    "r3kb1r/p3p1pp/b1pp4/q5N1/1PPPP3/P3n3/3KQPPP/RN5R b kq - 2 12",
+    "rn2k1nr/ppp1bp2/4p1pp/2Pp4/1P1P4/7N/P3PPPP/2KR1B1R b kq - 2 10",
+    "r3k1nr/ppp5/6pp/1PPn1p2/5N1P/6b1/P3BPP1/2KR3R b kq - 0 18",
+    "rnb1k1nr/pp4pp/2p2p2/3pp3/3P4/8/P1PNPPPP/4KB1R b Kkq - 1 8"
+  }},
+
+  // Flipping and cloning games similar to go
+  { "ataxx", {
+    "7/3p1pP/2p2PP/1p2PPp/3PPP1/7/p6 b - - 3 11",
+    "7/5PP/2p2PP/1PPP1PP/2PPPPP/3P1pp/pp5 b - - 2 18",
+    "PP2P2/1p5/2p4/5P1/2pPP1P/2pP2P/p5P b - - 0 9",
+    "2P4/pPP4/PPPP3/1PPP1P1/1P4p/pppp1PP/pp3PP b - - 3 20"
+  }},
+  { "flipello", {
+    "8/3P1P2/1PPpP3/1PPPPP2/1pPPp3/pppPpp2/2pPPP2/8[PPPPPPPPPPPPPPPPPPPPPpppppppppppppppppppppp] b - - 0 11",
+    "3p2p1/3p1p2/1PPppP2/1PPpPP2/PPPPpPpp/PPpppPPp/P1ppPPPP/2p4p[PPPPPPPPPPPPPPppppppppppppppp] b - - 0 18",
+    "8/3p4/3PPPP1/2ppPpp1/2PpPPp1/3ppppp/3p4/8[PPPPPPPPPPPPPPPPPPPPPPPpppppppppppppppppppppppp] b - - 0 9",
+    "2PPP1p1/1ppppP2/pppppPPp/1PPpPPPP/2PPpPP1/2pPPPpp/2PPPPp1/3PPP2[PPPPPPPPPPPPppppppppppppp] b - - 0 20"
+  }}
+};
+
 } // namespace
 
 namespace Stockfish {
 
 /// setup_bench() builds a list of UCI commands to be run by bench. There
-/// are five parameters: TT size in MB, number of search threads that
+/// are eight parameters: TT size in MB, number of search threads that
 /// should be used, the limit value spent for each position, a file name
 /// where to look for positions in FEN format, the type of the limit:
-/// depth, perft, nodes and movetime (in millisecs), and evaluation type
-/// mixed (default), classical, NNUE.
+/// depth, perft, nodes and movetime (in millisecs), evaluation type
+/// mixed (default), classical, NNUE, the number of times the whole set is
+/// run, each after a "ucinewgame", and the output format text (default),
+/// json or csv, which is returned in 'output'.
 ///
 /// bench -> search default positions up to depth 13
 /// bench 64 1 15 -> search default positions up to depth 15 (TT = 64MB)
 /// bench 64 4 5000 current movetime -> search current position with 4 threads for 5 sec
 /// bench 64 1 100000 default nodes -> search default positions for 100K nodes each
 /// bench 16 1 5 default perft -> run a perft 5 on default positions
+/// bench 16 1 13 default depth mixed 5 json -> run the default bench 5 times, print JSON
+/// bench xiangqi -> search the xiangqi start position and built-in xiangqi positions
 
-vector<string> setup_bench(const Position& current, istream& is) {
+vector<string> setup_bench(const Position& current, istream& is, string& output) {
 
   vector<string> fens, list;
   string go, token, varname;
@@ -134,13 +216,20 @@ vector<string> setup_bench(const Position& current, istream& is) {
   string fenFile   = (is >> token) ? token : "default";
   string limitType = (is >> token) ? token : "depth";
   string evalType  = (is >> token) ? token : "mixed";
+  int    repeat    = (is >> token) ? std::max(atoi(token.c_str()), 1) : 1;
+  output           = (is >> token) ? token : "text";
 
   go = limitType == "eval" ? "eval" : "go " + limitType + " " + limit;
 
   if (fenFile == "default")
   {
       if (varname != "chess")
+      {
           fens.push_back(variant->startFen);
+          auto it = VariantDefaults.find(varname);
+          if (it != VariantDefaults.end())
+              fens.insert(fens.end(), it->second.begin(), it->second.end());
+      }
       else
           fens = Defaults;
   }
@@ -169,23 +258,27 @@ vector<string> setup_bench(const Position& current, istream& is) {
   list.emplace_back("setoption name Threads value " + threads);
   list.emplace_back("setoption name Hash value " + ttSize);
   list.emplace_back("setoption name UCI_Variant value " + varname);
-  list.emplace_back("ucinewgame");
-
-  size_t posCounter = 0;
 
-  for (const string& fen : fens)
-      if (fen.find("setoption") != string::npos)
-          list.emplace_back(fen);
-      else
-      {
-          if (evalType == "classical" || (evalType == "mixed" && posCounter % 2 == 0))
-              list.emplace_back("setoption name Use NNUE value false");
-          else if (evalType == "NNUE" || (evalType == "mixed" && posCounter % 2 != 0))
-              list.emplace_back("setoption name Use NNUE value true");
-          list.emplace_back("position fen " + fen);
-          list.emplace_back(go);
-          ++posCounter;
-      }
+  for (int run = 0; run < repeat; ++run)
+  {
+      list.emplace_back("ucinewgame");
+
+      size_t posCounter = 0;
+
+      for (const string& fen : fens)
+          if (fen.find("setoption") != string::npos)
+              list.emplace_back(fen);
+          else
+          {
+              if (evalType == "classical" || (evalType == "mixed" && posCounter % 2 == 0))
+                  list.emplace_back("setoption name Use NNUE value false");
+              else if (evalType == "NNUE" || (evalType == "mixed" && posCounter % 2 != 0))
+                  list.emplace_back("setoption name Use NNUE value true");
+              list.emplace_back("position fen " + fen);
+              list.emplace_back(go);
+              ++posCounter;
+          }
+  }
 
   list.emplace_back("setoption name Use NNUE value true");
 
@@ -16,12 +16,31 @@
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <bitset>
 
 #include "bitboard.h"
+#include "position.h"
 #include "types.h"
+#include "variant.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#ifndef NOMINMAX
+#  define NOMINMAX // Disable macros min() and max()
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 namespace Stockfish {
 
@@ -66,6 +85,56 @@ namespace {
     Result result;
   };
 
+  // Generic bitbases record for pawnless endgames of up to four pieces whether
+  // the strong side, which is always white, can force mate. The pieces are
+  // ordered as in the endgame code, e.g. KCKR: strong king, chancellor, weak
+  // king, rook. The strong king is restricted to one half or one quarter of
+  // the board if all pieces move symmetrically.
+  constexpr int MAX_PIECES = 4;
+  constexpr size_t MAX_ENTRIES = size_t(1) << 27;
+
+  // Endgames whose evaluation functions consult a generic bitbase
+  const std::string GenericCodes[] = { "KNSK", "KCKR", "KAKR" };
+
+  struct Bitbase {
+    void canonicalize(Square* sq) const;
+    size_t index(Color stm, const Square* sq) const;
+    bool won(Color stm, Square* sq) const { canonicalize(sq); return bits[index(stm, sq)]; }
+
+    std::string code;
+    size_t id;
+    Piece pieces[MAX_PIECES];
+    int pieceCnt, weakKing;
+    File maxFile;
+    Rank maxRank;
+    int files, squares, kingFiles, kingSquares;
+    bool mirrorFiles, mirrorRanks;
+    size_t size, stride[MAX_PIECES];
+    const Bitbase* sub[MAX_PIECES]; // Bitbases reached by a capture
+    std::vector<bool> bits;
+  };
+
+  // The generic bitbases of the current variant are built on demand by a
+  // single background thread, the first time their material is probed, and
+  // are only probed once they are ready. Bitbases reached by captures are
+  // built before the ones leading to them.
+  constexpr size_t MAX_BITBASES = 16;
+
+  std::deque<Bitbase> GenericBitbases;
+  std::atomic<bool> Requested[MAX_BITBASES], Ready[MAX_BITBASES], Abort;
+  std::mutex BuilderMutex;
+  bool Building;
+
+  // The builder is stopped at exit if nobody cleared the bitbases before
+  struct BuilderThread : std::thread {
+    using std::thread::operator=;
+    ~BuilderThread() { if (joinable()) { Abort = true; join(); } }
+  } Builder;
+
+  const Bitbase* prepare(const Variant* v, const std::string& code);
+  void request(const Bitbase& bb);
+  bool build(Bitbase& bb);
+
 } // namespace
 
 bool Bitbases::probe(Square wksq, Square wpsq, Square bksq, Color stm) {
@@ -76,6 +145,46 @@ bool Bitbases::probe(Square wksq, Square wpsq, Square bksq, Color stm) {
 }
 
 
+/// Bitbases::probe() looks up the position in the generic bitbase of its
+/// material, if there is one, and sets win to whether strongSide can force mate.
+
+bool Bitbases::probe(const Position& pos, Color strongSide, bool& win) {
+
+  for (const Bitbase& bb : GenericBitbases)
+  {
+      if (   pos.count<ALL_PIECES>() != bb.pieceCnt
+          || pos.max_file() != bb.maxFile
+          || pos.max_rank() != bb.maxRank)
+          continue;
+
+      Square sq[MAX_PIECES];
+      int i = 0;
+      for ( ; i < bb.pieceCnt; ++i)
+      {
+          Color c = i < bb.weakKing ? strongSide : ~strongSide;
+          PieceType pt = type_of(bb.pieces[i]);
+          if (pos.count(c, pt) != 1)
+              break;
+          sq[i] = relative_square(strongSide, lsb(pos.pieces(c, pt)), pos.max_rank());
+      }
+
+      if (i == bb.pieceCnt)
+      {
+          if (!Ready[bb.id].load(std::memory_order_acquire))
+          {
+              request(bb);
+              return false;
+          }
+
+          win = bb.won(pos.side_to_move() == strongSide ? WHITE : BLACK, sq);
+          return true;
+      }
+  }
+
+  return false;
+}
+
+
 void Bitbases::init() {
 
 #ifdef LARGEBOARDS
@@ -102,6 +211,66 @@ void Bitbases::init() {
           KPKBitbase.set(idx);
 }
 
+
+/// Bitbases::init() sets up the generic bitbases of the endgames in
+/// GenericCodes that can occur in the given variant, as piece movements and
+/// board size depend on the variant. Each bitbase is computed in the
+/// background once its endgame is probed for the first time.
+
+void Bitbases::init(const Variant* v) {
+
+  clear();
+
+  if (   v->endgameEval != EG_EVAL_CHESS
+      || v->pieceDrops
+      || v->gating
+      || v->seirawanGating
+      || v->wallingRule != NO_WALLING
+      || v->cambodianMoves
+      || v->diagonalLines
+      || v->flyingGeneral
+      || v->pass[WHITE] || v->pass[BLACK]
+      || v->passOnStalemate[WHITE] || v->passOnStalemate[BLACK]
+      || !v->multimoves.empty()
+      || !v->checking
+      || v->shatarMateRule
+      || v->bikjangRule
+      || v->castlingWins)
+      return;
+
+  for (const std::string& code : GenericCodes)
+      prepare(v, code);
+}
+
+
+/// Bitbases::clear() stops building and frees the generic bitbases. It has
+/// to be called before the attack tables are changed for another variant.
+
+void Bitbases::clear() {
+
+  Abort = true;
+  if (Builder.joinable())
+      Builder.join();
+  Abort = false;
+
+  for (size_t id = 0; id < MAX_BITBASES; ++id)
+      Requested[id] = Ready[id] = false;
+  GenericBitbases.clear();
+}
+
+
+/// Bitbases::wait() requests all generic bitbases of the variant and blocks
+/// until they have been built, so that results do not depend on build timing.
+
+void Bitbases::wait() {
+
+  for (const Bitbase& bb : GenericBitbases)
+      request(bb);
+
+  if (Builder.joinable())
+      Builder.join();
+}
+
 namespace {
 
   KPKPosition::KPKPosition(unsigned idx) {
@@ -172,6 +341,526 @@ namespace {
     return result = r & Good  ? Good  : r & UNKNOWN ? UNKNOWN : Bad;
   }
 
+  void Bitbase::canonicalize(Square* sq) const {
+
+    if (mirrorFiles && file_of(sq[0]) >= kingFiles)
+        for (int i = 0; i < pieceCnt; ++i)
+            sq[i] = flip_file(sq[i], maxFile);
+
+    if (mirrorRanks && rank_of(sq[0]) >= kingSquares / kingFiles)
+        for (int i = 0; i < pieceCnt; ++i)
+            sq[i] = flip_rank(sq[i], maxRank);
+  }
+
+  // A generic bitbase index holds the side to move in the lowest bit, followed
+  // by the strong king square and the squares of the other pieces, numbered
+  // on the board of the variant.
+  size_t Bitbase::index(Color stm, const Square* sq) const {
+
+    size_t idx = stm + (rank_of(sq[0]) * kingFiles + file_of(sq[0])) * stride[0];
+    for (int i = 1; i < pieceCnt; ++i)
+        idx += (rank_of(sq[i]) * files + file_of(sq[i])) * stride[i];
+
+    return idx;
+  }
+
+  // Whether the moves of a piece are unchanged by mirroring the board, which
+  // allows to restrict the strong king to one half of the board.
+  bool mirrors(Color c, PieceType pt, File maxFile, Rank maxRank, bool fileAxis) {
+
+    Bitboard board = board_size_bb(maxFile, maxRank);
+    auto flip = [&](Square s) { return fileAxis ? flip_file(s, maxFile) : flip_rank(s, maxRank); };
+    auto flipped = [&](Bitboard b) {
+        Bitboard m = 0;
+        while (b)
+            m |= flip(pop_lsb(b));
+        return m;
+    };
+
+    for (Bitboard b = board; b; )
+    {
+        Square s = pop_lsb(b);
+        if (   flipped(moves_bb(c, pt, s, 0) & board) != (moves_bb(c, pt, flip(s), 0) & board)
+            || flipped(attacks_bb(c, pt, s, 0) & board) != (attacks_bb(c, pt, flip(s), 0) & board))
+            return false;
+    }
+    return true;
+  }
+
+  // Whether the moves and attacks of a piece are reversed by the ones of the
+  // same piece of the other color, as for all left-right symmetric pieces.
+  bool reverses(Color c, PieceType pt, File maxFile, Rank maxRank) {
+
+    Bitboard board = board_size_bb(maxFile, maxRank);
+
+    for (Bitboard b1 = board; b1; )
+    {
+        Square from = pop_lsb(b1);
+        for (Bitboard b2 = board; b2; )
+        {
+            Square to = pop_lsb(b2);
+            if (   bool(moves_bb(c, pt, from, 0) & to) != bool(moves_bb(~c, pt, to, 0) & from)
+                || bool(attacks_bb(c, pt, from, 0) & to) != bool(attacks_bb(~c, pt, to, 0) & from))
+                return false;
+        }
+    }
+    return true;
+  }
+
+  // BitbaseBuilder computes a generic bitbase by retrograde analysis. Every
+  // position is first classified by generating its moves, which resolves
+  // mates and captures into smaller bitbases, and counts for the weak side
+  // the moves that do not lose yet. Wins are then propagated to the positions
+  // preceding them until no new wins are found.
+  template<int N>
+  class BitbaseBuilder {
+
+    // Database entries are the number of unresolved moves of the weak side,
+    // together with flags for won positions and for pending wins.
+    static constexpr uint8_t WIN = 0x80, NEW = 0x40, INVALID = 0x3F;
+
+  public:
+    explicit BitbaseBuilder(Bitbase& b) : bb(b), db(b.size) {
+
+      board = board_size_bb(bb.maxFile, bb.maxRank);
+      hoppers = false;
+      for (int i = 0; i < N; ++i)
+      {
+          PieceType pt = type_of(bb.pieces[i]);
+          reversible[i] = reverses(color(i), pt, bb.maxFile, bb.maxRank);
+          verify[i] = !reversible[i] || (MoveRiderTypes[0][pt] & NON_SLIDING_RIDERS);
+          hoppers |= (AttackRiderTypes[pt] | MoveRiderTypes[0][pt]) & HOPPING_RIDERS;
+      }
+    }
+
+    bool run();
+
+  private:
+    Color color(int i) const { return i < bb.weakKing ? WHITE : BLACK; }
+    int first(Color c) const { return c == WHITE ? 0 : bb.weakKing; }
+    int last(Color c) const { return c == WHITE ? bb.weakKing : N; }
+
+    void decode(size_t idx, Color& stm, Square* sq) const;
+    bool attacks(Color c, const Square* sq, Bitboard occupied, Square s, int skip = -1) const;
+    bool capture_loses(int i, Square s, const Square* sq) const;
+    uint8_t classify(size_t idx) const;
+    void retract(size_t idx);
+
+    Bitbase& bb;
+    std::vector<uint8_t> db;
+    Bitboard board;
+    bool reversible[N], verify[N], hoppers;
+  };
+
+  template<int N>
+  void BitbaseBuilder<N>::decode(size_t idx, Color& stm, Square* sq) const {
+
+    stm = Color(idx & 1);
+    idx >>= 1;
+    size_t k = idx % bb.kingSquares;
+    sq[0] = make_square(File(k % bb.kingFiles), Rank(k / bb.kingFiles));
+    idx /= bb.kingSquares;
+    for (int i = 1; i < N; ++i, idx /= bb.squares)
+        sq[i] = make_square(File(idx % bb.squares % bb.files), Rank(idx % bb.squares / bb.files));
+  }
+
+  // Whether a piece of color c, except for the one with index skip, attacks s
+  template<int N>
+  bool BitbaseBuilder<N>::attacks(Color c, const Square* sq, Bitboard occupied, Square s, int skip) const {
+
+    for (int i = first(c); i < last(c); ++i)
+        if (i != skip && (attacks_bb(c, type_of(bb.pieces[i]), sq[i], occupied) & s))
+            return true;
+
+    return false;
+  }
+
+  // Whether the weak side may not win by capturing the piece on s, which
+  // leads to a smaller bitbase with the strong side to move
+  template<int N>
+  bool BitbaseBuilder<N>::capture_loses(int i, Square s, const Square* sq) const {
+
+    int captured = bb.weakKing;
+    while (sq[--captured] != s) {}
+
+    Square sq2[N];
+    std::copy(sq, sq + N, sq2);
+    sq2[i] = s;
+    std::copy(sq2 + captured + 1, sq2 + N, sq2 + captured);
+
+    return bb.sub[captured] && bb.sub[captured]->won(WHITE, sq2);
+  }
+
+  template<int N>
+  uint8_t BitbaseBuilder<N>::classify(size_t idx) const {
+
+    Color stm;
+    Square sq[N];
+    decode(idx, stm, sq);
+
+    Bitboard occupied = 0, whites = 0, blacks = 0;
+    for (int i = 0; i < N; ++i)
+        (i < bb.weakKing ? whites : blacks) |= sq[i];
+    occupied = whites | blacks;
+
+    Square wksq = sq[0], bksq = sq[bb.weakKing];
+
+    // Invalid if two pieces are on the same square or if a king can be captured
+    if (popcount(occupied) < N || attacks(stm, sq, occupied, stm == WHITE ? bksq : wksq))
+        return INVALID;
+
+    // Strong side to move: only captures are resolved here, the other moves
+    // are covered by the retraction of won positions.
+    if (stm == WHITE)
+    {
+        for (int j = bb.weakKing + 1; j < N; ++j)
+            for (int i = 0; i < bb.weakKing; ++i)
+            {
+                PieceType pt = type_of(bb.pieces[i]);
+                if (!(attacks_bb(WHITE, pt, sq[i], occupied) & sq[j]))
+                    continue;
+
+                Square sq2[N];
+                std::copy(sq, sq + N, sq2);
+                sq2[i] = sq[j];
+                if (attacks(BLACK, sq2, occupied ^ sq[i], sq2[0], j))
+                    continue;
+
+                std::copy(sq2 + j + 1, sq2 + N, sq2 + j);
+                if (bb.sub[j] && bb.sub[j]->won(BLACK, sq2))
+                    return WIN | NEW;
+            }
+
+        return 0;
+    }
+
+    // Weak side to move: count the legal moves, except for captures which
+    // lose anyway. Squares attacked by the strong side are computed with the
+    // weak king removed, so that it can not hide behind itself.
+    Bitboard attacked = 0;
+    for (int i = 0; i < bb.weakKing; ++i)
+        attacked |= attacks_bb(WHITE, type_of(bb.pieces[i]), sq[i], occupied ^ bksq);
+
+    bool inCheck = attacked & bksq;
+    int moves = 0, legal = 0;
+
+    for (int i = bb.weakKing; i < N; ++i)
+    {
+        PieceType pt = type_of(bb.pieces[i]);
+        Square from = sq[i];
+        Bitboard b = (  (moves_bb(BLACK, pt, from, occupied) & ~occupied)
+                      | (attacks_bb(BLACK, pt, from, occupied) & whites & ~square_bb(wksq))) & board;
+
+        // Without hoppers, legality only depends on the attacked squares for
+        // the king, and on whether the king is exposed for the other pieces.
+        bool exact = hoppers;
+        if (i == bb.weakKing)
+            b &= ~attacked;
+        else
+            exact |= attacks(WHITE, sq, occupied ^ from, bksq);
+
+        if (!exact)
+        {
+            int quiets = popcount(b & ~occupied);
+            moves += quiets;
+            legal += quiets;
+            b &= occupied;
+        }
+
+        while (b)
+        {
+            Square to = pop_lsb(b);
+
+            if (exact)
+            {
+                Square sq2[N];
+                std::copy(sq, sq + N, sq2);
+                sq2[i] = to;
+
+                int captured = -1;
+                for (int j = 1; j < bb.weakKing; ++j)
+                    if (sq[j] == to)
+                        captured = j;
+
+                if (attacks(WHITE, sq2, (occupied ^ from) | to, sq2[bb.weakKing], captured))
+                    continue;
+            }
+
+            legal++;
+            if (!(whites & to) || !capture_loses(i, to, sq))
+                moves++; // Captures which do not lose are never resolved
+        }
+    }
+
+    // Mate, or stalemate, which is kept unresolved
+    if (!legal)
+        return inCheck ? WIN | NEW : 1;
+
+    assert(moves < INVALID);
+
+    return moves ? uint8_t(moves) : WIN | NEW;
+  }
+
+  // Mark the positions leading to a newly won position. If the strong side
+  // moved, it wins the preceding position. If the weak side moved, this was
+  // one move less to escape from the preceding position.
+  template<int N>
+  void BitbaseBuilder<N>::retract(size_t idx) {
+
+    Color stm;
+    Square sq[N];
+    decode(idx, stm, sq);
+
+    Color mover = ~stm;
+    Square ksq = sq[first(stm)];
+    Bitboard occupied = 0;
+    for (int i = 0; i < N; ++i)
+        occupied |= sq[i];
+
+    for (int i = first(mover); i < last(mover); ++i)
+    {
+        PieceType pt = type_of(bb.pieces[i]);
+        Square to = sq[i];
+        Bitboard b = (reversible[i] ? moves_bb(stm, pt, to, occupied ^ to) : board) & board & ~occupied;
+
+        // Exclude the squares from which the piece would have attacked the king
+        if (!verify[i])
+            b &= ~attacks_bb(stm, pt, ksq, occupied ^ to);
+
+        // Without hoppers, the other pieces of the mover can only give check
+        // in the preceding position if they do so without the moved piece.
+        bool exact = hoppers || attacks(mover, sq, occupied ^ to, ksq, i);
+
+        while (b)
+        {
+            Square from = pop_lsb(b);
+            Bitboard occupied2 = (occupied ^ to) | from;
+
+            if (   verify[i]
+                && (   !(moves_bb(mover, pt, from, occupied2) & to)
+                    ||  (attacks_bb(mover, pt, from, occupied2) & ksq)))
+                continue;
+
+            sq[i] = from;
+            if (exact && attacks(mover, sq, occupied2, ksq))
+                continue;
+
+            // Only a move of the strong king can leave the canonical squares
+            size_t idx2;
+            if (i == 0)
+            {
+                Square sq2[N];
+                std::copy(sq, sq + N, sq2);
+                bb.canonicalize(sq2);
+                idx2 = bb.index(mover, sq2);
+            }
+            else
+                idx2 =  idx + mover - stm
+                      + ((rank_of(from) - rank_of(to)) * bb.files + file_of(from) - file_of(to)) * bb.stride[i];
+
+            uint8_t& e = db[idx2];
+
+            assert(e != INVALID);
+
+            if (!(e & WIN))
+                e = mover == WHITE || e == 1 ? WIN | NEW : e - 1;
+        }
+
+        sq[i] = to;
+    }
+  }
+
+  // Runs a function on all indices of the database. Returns false if
+  // building has been aborted.
+  template<typename F>
+  bool for_each_index(size_t size, const F& f) {
+
+    for (size_t idx = 0; idx < size; ++idx)
+    {
+        if (idx % 65536 == 0 && Abort.load(std::memory_order_relaxed))
+            return false;
+        f(idx);
+    }
+
+    return true;
+  }
+
+  template<int N>
+  bool BitbaseBuilder<N>::run() {
+
+    if (!for_each_index(bb.size, [this](size_t idx) {
+            db[idx] = classify(idx);
+        }))
+        return false;
+
+    // Propagate the wins until no pending ones are left
+    for (bool pending = true; pending; )
+    {
+        pending = false;
+        if (!for_each_index(bb.size, [this, &pending](size_t idx) {
+                if (db[idx] & NEW)
+                {
+                    db[idx] &= uint8_t(~NEW);
+                    retract(idx);
+                    pending = true;
+                }
+            }))
+            return false;
+    }
+
+    bb.bits.resize(bb.size);
+    for (size_t idx = 0; idx < bb.size; ++idx)
+        bb.bits[idx] = db[idx] & WIN;
+
+    return true;
+  }
+
+  // Sets up the generic bitbase of an endgame code, after the smaller bitbases
+  // reached by captures. Returns nullptr if the strong side has a lone king,
+  // or if the code does not fit the variant.
+  const Bitbase* prepare(const Variant* v, const std::string& code) {
+
+    size_t weakKing = code.find('K', 1);
+    int pieceCnt = int(code.size());
+
+    if (weakKing == 1 || weakKing == std::string::npos || pieceCnt > MAX_PIECES)
+        return nullptr;
+
+    for (const Bitbase& bb : GenericBitbases)
+        if (bb.code == code)
+            return &bb;
+
+    Bitbase bb;
+    bb.code = code;
+    bb.pieceCnt = pieceCnt;
+    bb.weakKing = int(weakKing);
+    bb.maxFile = v->maxFile;
+    bb.maxRank = v->maxRank;
+    bb.files = v->maxFile + 1;
+    bb.squares = bb.files * (v->maxRank + 1);
+    bb.mirrorFiles = bb.files % 2 == 0;
+    bb.mirrorRanks = (v->maxRank + 1) % 2 == 0;
+
+    // Piece letters of endgame codes are the ones of the fairy variant
+    const std::string& pieceToChar = variants.find("fairy")->second->pieceToChar;
+
+    for (int i = 0; i < pieceCnt; ++i)
+    {
+        Color c = i < bb.weakKing ? WHITE : BLACK;
+        size_t pc = pieceToChar.find(code[i]);
+        PieceType pt = pc != std::string::npos ? type_of(Piece(pc)) : NO_PIECE_TYPE;
+
+        if (   pt == NO_PIECE_TYPE
+            || !(v->pieceTypes & pt)
+            || v->promotedPieceType[pt] != NO_PIECE_TYPE
+            || (v->promotionPawnTypes[WHITE] & pt)
+            || (v->promotionPawnTypes[BLACK] & pt)
+            || v->mobilityRegion[WHITE][pt]
+            || v->mobilityRegion[BLACK][pt])
+            return nullptr;
+
+        bb.pieces[i] = make_piece(c, pt);
+        bb.mirrorFiles &= mirrors(c, pt, bb.maxFile, bb.maxRank, true);
+        bb.mirrorRanks &= mirrors(c, pt, bb.maxFile, bb.maxRank, false);
+    }
+
+    bb.kingFiles = bb.mirrorFiles ? bb.files / 2 : bb.files;
+    bb.kingSquares = bb.kingFiles * (bb.mirrorRanks ? (v->maxRank + 1) / 2 : v->maxRank + 1);
+    bb.stride[0] = 2;
+    bb.size = 2 * size_t(bb.kingSquares);
+    for (int i = 1; i < pieceCnt; ++i)
+    {
+        bb.stride[i] = bb.size;
+        bb.size *= bb.squares;
+    }
+
+    if (bb.size > MAX_ENTRIES)
+        return nullptr;
+
+    for (int i = 0; i < pieceCnt; ++i)
+        bb.sub[i] = i && i != bb.weakKing ? prepare(v, code.substr(0, i) + code.substr(i + 1)) : nullptr;
+
+    assert(GenericBitbases.size() < MAX_BITBASES);
+
+    bb.id = GenericBitbases.size();
+    GenericBitbases.push_back(std::move(bb));
+    return &GenericBitbases.back();
+  }
+
+  bool build(Bitbase& bb) {
+
+    return bb.pieceCnt == 3 ? BitbaseBuilder<3>(bb).run()
+                            : BitbaseBuilder<4>(bb).run();
+  }
+
+  // Lowers the priority of the calling thread, so that building bitbases
+  // does not slow down the search threads
+  void lower_priority() {
+
+#if defined(_WIN32)
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_IDLE);
+#elif defined(__linux__)
+    setpriority(PRIO_PROCESS, pid_t(syscall(SYS_gettid)), 19);
+#endif
+  }
+
+  // Marks a bitbase and the ones reached by captures for building, and starts
+  // the builder thread if it is not running yet. The builder builds pending
+  // bitbases in the order of GenericBitbases, where the smaller ones come first.
+  void request(const Bitbase& bb) {
+
+    for (int i = 0; i < bb.pieceCnt; ++i)
+        if (bb.sub[i])
+            request(*bb.sub[i]);
+
+    if (Requested[bb.id].exchange(true))
+        return;
+
+    std::lock_guard<std::mutex> lk(BuilderMutex);
+
+    if (Building)
+        return;
+
+    if (Builder.joinable())
+        Builder.join();
+
+    Building = true;
+    Builder = std::thread([]() {
+
+        lower_priority();
+
+        while (true)
+        {
+            Bitbase* next = nullptr;
+            {
+                std::lock_guard<std::mutex> lk2(BuilderMutex);
+
+                for (Bitbase& b : GenericBitbases)
+                    if (Requested[b.id] && !Ready[b.id])
+                    {
+                        next = &b;
+                        break;
+                    }
+
+                if (!next)
+                {
+                    Building = false;
+                    return;
+                }
+            }
+
+            if (!build(*next))
+            {
+                std::lock_guard<std::mutex> lk2(BuilderMutex);
+                Building = false;
+                return;
+            }
+
+            Ready[next->id].store(true, std::memory_order_release);
+        }
+    });
+  }
+
 } // namespace
 
 } // namespace Stockfish
@@ -25,10 +25,17 @@
 
 namespace Stockfish {
 
+class Position;
+struct Variant;
+
 namespace Bitbases {
 
 void init();
+void init(const Variant* v);
+void clear();
+void wait();
 bool probe(Square wksq, Square wpsq, Square bksq, Color us);
+bool probe(const Position& pos, Color strongSide, bool& win);
 
 } // namespace Stockfish::Bitbases
 
@@ -20,7 +20,9 @@
 
 #include "bitboard.h"
 #include "endgame.h"
+#include "misc.h"
 #include "movegen.h"
+#include "variant.h"
 
 namespace Stockfish {
 
@@ -73,7 +75,10 @@ namespace {
 
 namespace Endgames {
 
-  std::pair<Map<Value>, Map<ScaleFactor>> maps;
+  std::pair<List<Value>, List<ScaleFactor>> lists;
+  std::vector<Slot> table(2, Slot());
+  Key multiplier = 1;
+  int shift = 63;
 
   void init() {
 
@@ -126,6 +131,57 @@ namespace Endgames {
     add<KBPPKB>("KBPPKB");
     add<KRPPKRP>("KRPPKRP");
   }
+
+  /// Endgames::init() with a variant builds the perfect hash table of the endgames
+  /// relevant to the variant. The slot of a key is given by the top bits of its
+  /// product with a multiplier, which is searched for until there are no
+  /// collisions, doubling the table size from time to time.
+  void init(const Variant* v) {
+
+    std::vector<Slot> slots;
+
+    auto slot = [&](Key key) -> Slot& {
+        for (Slot& s : slots)
+            if (s.key == key)
+                return s;
+        return slots.emplace_back(Slot{ key, nullptr, nullptr });
+    };
+
+    for (const auto& e : list<Value>())
+        if (e.eval == v->endgameEval && !(e.pieceTypes & ~v->pieceTypes))
+            slot(e.key).evaluation = e.func.get();
+
+    for (const auto& e : list<ScaleFactor>())
+        if (e.eval == v->endgameEval && !(e.pieceTypes & ~v->pieceTypes))
+            slot(e.key).scaling = e.func.get();
+
+    PRNG rng(1070372);
+    int bits = 1;
+    while ((size_t(1) << bits) < 2 * slots.size())
+        ++bits;
+
+    for (int attempt = 1; ; ++attempt)
+    {
+        if (attempt % 64 == 0 && bits < 16)
+            ++bits;
+
+        multiplier = rng.rand<Key>() | 1;
+        shift = 64 - bits;
+        table.assign(size_t(1) << bits, Slot());
+
+        bool collision = false;
+        for (const Slot& s : slots)
+        {
+            Slot& t = table[(s.key * multiplier) >> shift];
+            if ((collision = t.evaluation || t.scaling))
+                break;
+            t = s;
+        }
+
+        if (!collision)
+            break;
+    }
+  }
 }
 
 
@@ -140,7 +196,7 @@ Value Endgame<KXK>::operator()(const Position& pos) const {
   assert(!pos.checkers()); // Eval is never called when in check
 
   // Stalemate detection with lone king
-  if (pos.side_to_move() == weakSide && !MoveList<LEGAL>(pos).size())
+  if (pos.side_to_move() == weakSide && !pos.has_any_legal_move())
       return VALUE_DRAW;
 
   Square strongKing = pos.square<KING>(strongSide);
@@ -346,6 +402,7 @@ Value Endgame<KQKR>::operator()(const Position& pos) const {
 
 
 /// KC vs KR. Drawish, but good winning chances if king and rook are close.
+/// The bitbase of the variant, once built, tells the won positions.
 template<>
 Value Endgame<KCKR>::operator()(const Position& pos) const {
 
@@ -360,11 +417,21 @@ Value Endgame<KCKR>::operator()(const Position& pos) const {
                 + push_close(strongKing, weakKing)
                 + push_close(weakRook, weakKing);
 
+  bool win;
+  if (Bitbases::probe(pos, strongSide, win))
+  {
+      if (!win)
+          return VALUE_DRAW;
+
+      result += VALUE_KNOWN_WIN;
+  }
+
   return strongSide == pos.side_to_move() ? result : -result;
 }
 
 
-/// KA vs KR. Very drawish.
+/// KA vs KR. Very drawish. The bitbase of the variant, once built, tells
+/// the won positions.
 template<>
 Value Endgame<KAKR>::operator()(const Position& pos) const {
 
@@ -377,6 +444,15 @@ Value Endgame<KAKR>::operator()(const Position& pos) const {
   Value result =  Value(push_to_edge(weakKing, pos))
                 + push_close(strongKing, weakKing);
 
+  bool win;
+  if (Bitbases::probe(pos, strongSide, win))
+  {
+      if (!win)
+          return VALUE_DRAW;
+
+      result += VALUE_KNOWN_WIN;
+  }
+
   return strongSide == pos.side_to_move() ? result : -result;
 }
 
@@ -450,13 +526,18 @@ Value Endgame<KFsPsK>::operator()(const Position& pos) const {
 }
 
 
-/// Mate with KNS vs K.
+/// Mate with KNS vs K. The bitbase of the variant, once built, tells the
+/// few positions where the mate can not be forced.
 template<>
 Value Endgame<KNSK>::operator()(const Position& pos) const {
 
   assert(verify_material(pos, strongSide, KnightValueMg + SilverValueMg, 0));
   assert(verify_material(pos, weakSide, VALUE_ZERO, 0));
 
+  bool win;
+  if (Bitbases::probe(pos, strongSide, win) && !win)
+      return VALUE_DRAW;
+
   Square winnerKSq = pos.square<KING>(strongSide);
   Square loserKSq = pos.square<KING>(weakSide);
 
@@ -1077,7 +1158,7 @@ Value Endgame<KXK, EG_EVAL_ATOMIC>::operator()(const Position& pos) const {
   assert(pos.endgame_eval() == EG_EVAL_ATOMIC);
 
   // Stalemate detection with lone king
-  if (pos.side_to_move() == weakSide && !MoveList<LEGAL>(pos).size())
+  if (pos.side_to_move() == weakSide && !pos.has_any_legal_move())
       return VALUE_DRAW;
 
   Square winnerKSq = pos.square<COMMONER>(strongSide);
@@ -1130,7 +1211,7 @@ Value Endgame<KQK, EG_EVAL_ATOMIC>::operator()(const Position& pos) const {
   assert(pos.endgame_eval() == EG_EVAL_ATOMIC);
 
   // Stalemate detection with lone king
-  if (pos.side_to_move() == weakSide && !MoveList<LEGAL>(pos).size())
+  if (pos.side_to_move() == weakSide && !pos.has_any_legal_move())
       return VALUE_DRAW;
 
   Square winnerKSq = pos.square<COMMONER>(strongSide);
@@ -1163,7 +1244,7 @@ Value Endgame<KXKX, EG_EVAL_MISERE>::operator()(const Position& pos) const {
   assert(!pos.checkers()); // Eval is never called when in check
 
   // Stalemate detection with lone king
-  if (pos.side_to_move() == weakSide && !MoveList<LEGAL>(pos).size())
+  if (pos.side_to_move() == weakSide && !pos.has_any_legal_move())
       return VALUE_DRAW;
 
   Square strongKing = pos.square<KING>(strongSide);
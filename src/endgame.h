@@ -22,8 +22,8 @@
 #include <memory>
 #include <string>
 #include <type_traits>
-#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "position.h"
 #include "types.h"
@@ -114,32 +114,71 @@ struct Endgame : public EndgameBase<T> {
 /// base objects in two std::map. We use polymorphism to invoke the actual
 /// endgame function by calling its virtual operator().
 
+/// Endgames keeps all the endgame functions in a list. The ones relevant to the
+/// current variant, i.e. of its EndgameEval family and using only its piece
+/// types, are also stored in a perfect hash table of their material keys, so
+/// that a probe is a single table access.
+
 namespace Endgames {
 
   template<typename T> using Ptr = std::unique_ptr<EndgameBase<T>>;
-  template<typename T> using Map = std::unordered_map<Key, Ptr<T>>;
 
-  extern std::pair<Map<Value>, Map<ScaleFactor>> maps;
+  template<typename T>
+  struct Entry {
+    Key key;
+    EndgameEval eval;
+    PieceSet pieceTypes;
+    Ptr<T> func;
+  };
+
+  template<typename T> using List = std::vector<Entry<T>>;
+
+  struct Slot {
+    Key key;
+    const EndgameBase<Value>* evaluation;
+    const EndgameBase<ScaleFactor>* scaling;
+  };
+
+  extern std::pair<List<Value>, List<ScaleFactor>> lists;
+  extern std::vector<Slot> table;
+  extern Key multiplier;
+  extern int shift;
 
   void init();
+  void init(const Variant* v);
 
   template<typename T>
-  Map<T>& map() {
-    return std::get<std::is_same<T, ScaleFactor>::value>(maps);
+  List<T>& list() {
+    return std::get<std::is_same<T, ScaleFactor>::value>(lists);
   }
 
   template<EndgameCode E, EndgameEval V = EG_EVAL_CHESS, typename T = eg_type<E, V>>
   void add(const std::string& code) {
 
     StateInfo st;
-    map<T>()[Position().set(code, WHITE, &st).material_key(V)] = Ptr<T>(new Endgame<E, V>(WHITE));
-    map<T>()[Position().set(code, BLACK, &st).material_key(V)] = Ptr<T>(new Endgame<E, V>(BLACK));
+    for (Color c : { WHITE, BLACK })
+    {
+        Position pos;
+        pos.set(code, c, &st);
+
+        PieceSet pieceTypes = NO_PIECE_SET;
+        for (PieceType pt = PAWN; pt <= KING; ++pt)
+            if (pos.pieces(pt))
+                pieceTypes |= pt;
+
+        list<T>().push_back({ pos.material_key(V), V, pieceTypes, Ptr<T>(new Endgame<E, V>(c)) });
+    }
   }
 
   template<typename T>
   const EndgameBase<T>* probe(Key key) {
-    auto it = map<T>().find(key);
-    return it != map<T>().end() ? it->second.get() : nullptr;
+    const Slot& s = table[(key * multiplier) >> shift];
+    if (s.key != key)
+        return nullptr;
+    if constexpr (std::is_same<T, ScaleFactor>::value)
+        return s.scaling;
+    else
+        return s.evaluation;
   }
 }
 
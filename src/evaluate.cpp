@@ -323,7 +323,7 @@ namespace {
 
   public:
     Evaluation() = delete;
-    explicit Evaluation(const Position& p) : pos(p) {}
+    explicit Evaluation(const Position& p) : pos(p), attackIndex(p.variant()->attackIndex) {}
     Evaluation& operator=(const Evaluation&) = delete;
     Value value();
 
@@ -338,16 +338,21 @@ namespace {
     template<Color Us> Score variant() const;
     Value winnable(Score score) const;
 
+    Bitboard& attacked_by(Color c, PieceType pt) { return attackedBy[attackIndex[pt]][c]; }
+    Bitboard attacked_by(Color c, PieceType pt) const { return attackedBy[attackIndex[pt]][c]; }
+
     const Position& pos;
     Material::Entry* me;
     Pawns::Entry* pe;
     Bitboard mobilityArea[COLOR_NB];
     Score mobility[COLOR_NB] = { SCORE_ZERO, SCORE_ZERO };
 
-    // attackedBy[color][piece type] is a bitboard representing all squares
+    // attacked_by(color, piece type) is a bitboard representing all squares
     // attacked by a given color and piece type. Special "piece types" which
-    // is also calculated is ALL_PIECES.
-    Bitboard attackedBy[COLOR_NB][PIECE_TYPE_NB];
+    // is also calculated is ALL_PIECES. The tables are only kept for the piece
+    // types of the variant, see Variant::attackIndex.
+    const int* attackIndex;
+    Bitboard attackedBy[PIECE_TYPE_NB + 1][COLOR_NB];
 
     // attackedBy2[color] are the squares attacked by at least 2 units of a given
     // color, including x-rays. But diagonal x-rays through pawns are not computed.
@@ -407,15 +412,15 @@ namespace {
                                | shift<EAST>(pos.promoted_soldiers(Them))
                                | shift<WEST>(pos.promoted_soldiers(Them)));
 
-    // Initialize attackedBy[] for king and pawns
-    attackedBy[Us][KING] = pos.count<KING>(Us) ? pos.attacks_from(Us, KING, ksq) : Bitboard(0);
-    attackedBy[Us][PAWN] = pe->pawn_attacks(Us);
-    attackedBy[Us][SHOGI_PAWN] = shift<Up>(pos.pieces(Us, SHOGI_PAWN));
-    attackedBy[Us][ALL_PIECES] = attackedBy[Us][KING] | attackedBy[Us][PAWN] | attackedBy[Us][SHOGI_PAWN];
-    attackedBy2[Us]            =  (attackedBy[Us][KING] & attackedBy[Us][PAWN])
-                                | (attackedBy[Us][KING] & attackedBy[Us][SHOGI_PAWN])
-                                | (attackedBy[Us][PAWN] & attackedBy[Us][SHOGI_PAWN])
-                                | dblAttackByPawn;
+    // Initialize attacked_by() for king and pawns
+    attacked_by(Us, KING)       = pos.count<KING>(Us) ? pos.attacks_from(Us, KING, ksq) : Bitboard(0);
+    attacked_by(Us, PAWN)       = pe->pawn_attacks(Us);
+    attacked_by(Us, SHOGI_PAWN) = shift<Up>(pos.pieces(Us, SHOGI_PAWN));
+    attacked_by(Us, ALL_PIECES) = attacked_by(Us, KING) | attacked_by(Us, PAWN) | attacked_by(Us, SHOGI_PAWN);
+    attackedBy2[Us]             =  (attacked_by(Us, KING) & attacked_by(Us, PAWN))
+                                 | (attacked_by(Us, KING) & attacked_by(Us, SHOGI_PAWN))
+                                 | (attacked_by(Us, PAWN) & attacked_by(Us, SHOGI_PAWN))
+                                 | dblAttackByPawn;
 
     // Init our king safety tables
     if (!pos.count<KING>(Us))
@@ -451,7 +456,7 @@ namespace {
     Bitboard b, bb;
     Score score = SCORE_ZERO;
 
-    attackedBy[Us][Pt] = 0;
+    attacked_by(Us, Pt) = 0;
 
     while (b1)
     {
@@ -468,15 +473,15 @@ namespace {
         if (pos.blockers_for_king(Us) & s)
             b &= line_bb(pos.square<KING>(Us), s);
 
-        attackedBy2[Us] |= attackedBy[Us][ALL_PIECES] & b;
-        attackedBy[Us][Pt] |= b;
-        attackedBy[Us][ALL_PIECES] |= b;
+        attackedBy2[Us] |= attacked_by(Us, ALL_PIECES) & b;
+        attacked_by(Us, Pt) |= b;
+        attacked_by(Us, ALL_PIECES) |= b;
 
         if (b & kingRing[Them])
         {
             kingAttackersCount[Us]++;
             kingAttackersWeight[Us] += KingAttackWeights[std::min(Pt, FAIRY_PIECES)];
-            kingAttacksCount[Us] += popcount(b & attackedBy[Them][KING]);
+            kingAttacksCount[Us] += popcount(b & attacked_by(Them, KING));
         }
 
         else if (Pt == ROOK && (file_bb(s) & kingRing[Them]))
@@ -526,7 +531,7 @@ namespace {
         {
             // Bonus if the piece is on an outpost square or can reach one
             // Bonus for knights (UncontestedOutpost) if few relevant targets
-            bb = OutpostRanks & (attackedBy[Us][PAWN] | shift<Down>(pos.pieces(PAWN)))
+            bb = OutpostRanks & (attacked_by(Us, PAWN) | shift<Down>(pos.pieces(PAWN)))
                               & ~pe->pawn_attacks_span(Them);
             Bitboard targets = pos.pieces(Them) & ~pos.pieces(PAWN);
 
@@ -556,7 +561,7 @@ namespace {
                 Bitboard blocked = pos.pieces(Us, PAWN) & shift<Down>(pos.pieces());
 
                 score -= BishopPawns[edge_distance(file_of(s), pos.max_file())] * pos.pawns_on_same_color_squares(Us, s)
-                                     * (!(attackedBy[Us][PAWN] & s) + popcount(blocked & CenterFiles));
+                                     * (!(attacked_by(Us, PAWN) & s) + popcount(blocked & CenterFiles));
 
                 // Penalty for all enemy pawns x-rayed
                 score -= BishopXRayPawns * popcount(attacks_bb<BISHOP>(s) & pos.pieces(Them, PAWN));
@@ -630,15 +635,15 @@ namespace {
 
     if (pos.count_in_hand(Us, pt) > 0 && pt != KING)
     {
-        Bitboard b = pos.drop_region(Us, pt) & ~pos.pieces() & (~attackedBy2[Them] | attackedBy[Us][ALL_PIECES]);
+        Bitboard b = pos.drop_region(Us, pt) & ~pos.pieces() & (~attackedBy2[Them] | attacked_by(Us, ALL_PIECES));
         if ((b & kingRing[Them]) && pt != SHOGI_PAWN)
         {
             kingAttackersCountInHand[Us] += pos.count_in_hand(Us, pt);
             kingAttackersWeightInHand[Us] += KingAttackWeights[std::min(pt, FAIRY_PIECES)] * pos.count_in_hand(Us, pt);
-            kingAttacksCount[Us] += popcount(b & attackedBy[Them][KING]);
+            kingAttacksCount[Us] += popcount(b & attacked_by(Them, KING));
         }
         Bitboard theirHalf = pos.board_bb() & ~forward_ranks_bb(Them, relative_rank(Them, Rank((pos.max_rank() - 1) / 2), pos.max_rank()));
-        mobility[Us] += DropMobility * popcount(b & theirHalf & ~attackedBy[Them][ALL_PIECES]);
+        mobility[Us] += DropMobility * popcount(b & theirHalf & ~attacked_by(Them, ALL_PIECES));
 
         // Bonus for Kyoto shogi style drops of promoted pieces
         if (pos.promoted_piece_type(pt) != NO_PIECE_TYPE && pos.drop_promoted())
@@ -682,20 +687,20 @@ namespace {
     Score score = pe->king_safety<Us>(pos);
 
     // Attacked squares defended at most once by our queen or king
-    weak =  attackedBy[Them][ALL_PIECES]
+    weak =  attacked_by(Them, ALL_PIECES)
           & ~attackedBy2[Us]
-          & (~attackedBy[Us][ALL_PIECES] | attackedBy[Us][KING] | attackedBy[Us][QUEEN]);
+          & (~attacked_by(Us, ALL_PIECES) | attacked_by(Us, KING) | attacked_by(Us, QUEEN));
 
     // Analyse the safe enemy's checks which are possible on next move
     safe  = ~pos.pieces(Them);
     if (!pos.check_counting() || pos.checks_remaining(Them) > 1)
-    safe &= ~attackedBy[Us][ALL_PIECES] | (weak & attackedBy2[Them]);
+    safe &= ~attacked_by(Us, ALL_PIECES) | (weak & attackedBy2[Them]);
 
     b1 = attacks_bb<ROOK  >(ksq, pos.pieces() ^ pos.pieces(Us, QUEEN));
     b2 = attacks_bb<BISHOP>(ksq, pos.pieces() ^ pos.pieces(Us, QUEEN));
 
-    std::function <Bitboard (Color, PieceType)> get_attacks = [this](Color c, PieceType pt) {
-        return attackedBy[c][pt] | (pos.piece_drops() && pos.count_in_hand(c, pt) > 0 ? pos.drop_region(c, pt) & ~pos.pieces() : Bitboard(0));
+    auto get_attacks = [&](Color c, PieceType pt) {
+        return attacked_by(c, pt) | (pos.piece_drops() && pos.count_in_hand(c, pt) > 0 ? pos.drop_region(c, pt) & ~pos.pieces() : Bitboard(0));
     };
     for (PieceSet ps = pos.piece_types(); ps;)
     {
@@ -709,8 +714,8 @@ namespace {
                         & get_attacks(Them, QUEEN)
                         & pos.board_bb()
                         & safe
-                        & ~attackedBy[Us][QUEEN]
-                        & ~(b1 & attackedBy[Them][ROOK]);
+                        & ~attacked_by(Us, QUEEN)
+                        & ~(b1 & attacked_by(Them, ROOK));
 
             if (queenChecks)
                 kingDanger += SafeCheck[QUEEN][more_than_one(queenChecks)];
@@ -737,7 +742,7 @@ namespace {
         case SHOGI_PAWN:
             if (pos.promoted_piece_type(pt))
             {
-                otherChecks = attacks_bb(Us, pos.promoted_piece_type(pt), ksq, pos.pieces()) & attackedBy[Them][pt]
+                otherChecks = attacks_bb(Us, pos.promoted_piece_type(pt), ksq, pos.pieces()) & attacked_by(Them, pt)
                                  & pos.promotion_zone(Them, pt) & pos.board_bb();
                 if (otherChecks & safe)
                     kingDanger += SafeCheck[FAIRY_PIECES][more_than_one(otherChecks & safe)];
@@ -766,7 +771,7 @@ namespace {
             {
                 kingDanger += VirtualCheck * 500 / (500 + PieceValue[MG][pt]);
                 // Presumably a mate threat
-                if (!(attackedBy[Us][KING] & ~(attackedBy[Them][ALL_PIECES] | pos.pieces(Us))))
+                if (!(attacked_by(Us, KING) & ~(attacked_by(Them, ALL_PIECES) | pos.pieces(Us))))
                     kingDanger += 2000;
             }
         }
@@ -780,9 +785,9 @@ namespace {
 
     // Find the squares that opponent attacks in our king flank, the squares
     // which they attack twice in that flank, and the squares that we defend.
-    b1 = attackedBy[Them][ALL_PIECES] & kingFlank & Camp;
+    b1 = attacked_by(Them, ALL_PIECES) & kingFlank & Camp;
     b2 = b1 & attackedBy2[Them];
-    b3 = attackedBy[Us][ALL_PIECES] & kingFlank & Camp;
+    b3 = attacked_by(Us, ALL_PIECES) & kingFlank & Camp;
 
     int kingFlankAttack  = popcount(b1) + popcount(b2);
     int kingFlankDefense = popcount(b3);
@@ -799,7 +804,7 @@ namespace {
                  - 873 * !(pos.major_pieces(Them) || pos.captures_to_hand())
                        * 2 / (2 + 2 * pos.check_counting() + 2 * pos.two_boards() + 2 * pos.makpong()
                                 + (pos.king_type() != KING) * (pos.diagonal_lines() ? 1 : 2))
-                 - 100 * bool(attackedBy[Us][KNIGHT] & attackedBy[Us][KING])
+                 - 100 * bool(attacked_by(Us, KNIGHT) & attacked_by(Us, KING))
                  -   6 * mg_value(score) / 8
                  -   4 * kingFlankDefense
                  +  37;
@@ -850,9 +855,9 @@ namespace {
     if (pos.must_capture())
     {
         // Penalties for possible captures
-        Bitboard captures = attackedBy[Us][ALL_PIECES] & pos.pieces(Them);
+        Bitboard captures = attacked_by(Us, ALL_PIECES) & pos.pieces(Them);
         if (captures)
-            score -= make_score(2000, 2000) / (1 + popcount(captures & attackedBy[Them][ALL_PIECES] & ~attackedBy2[Us]));
+            score -= make_score(2000, 2000) / (1 + popcount(captures & attacked_by(Them, ALL_PIECES) & ~attackedBy2[Us]));
 
         // Bonus if we threaten to force captures
         Bitboard moves = 0, piecebb = pos.pieces(Us);
@@ -862,14 +867,14 @@ namespace {
             if (type_of(pos.piece_on(s)) != KING)
                 moves |= pos.moves_from(Us, type_of(pos.piece_on(s)), s);
         }
-        score += make_score(200, 200) * popcount(attackedBy[Them][ALL_PIECES] & moves & ~pos.pieces());
-        score += make_score(200, 220) * popcount(attackedBy[Them][ALL_PIECES] & moves & ~pos.pieces() & ~attackedBy2[Us]);
+        score += make_score(200, 200) * popcount(attacked_by(Them, ALL_PIECES) & moves & ~pos.pieces());
+        score += make_score(200, 220) * popcount(attacked_by(Them, ALL_PIECES) & moves & ~pos.pieces() & ~attackedBy2[Us]);
     }
 
     // Extinction threats
     if (pos.extinction_value() == -VALUE_MATE)
     {
-        Bitboard bExt = attackedBy[Us][ALL_PIECES] & pos.pieces(Them);
+        Bitboard bExt = attacked_by(Us, ALL_PIECES) & pos.pieces(Them);
         for (PieceSet ps = pos.extinction_piece_types(); ps;)
         {
             PieceType pt = pop_lsb(ps);
@@ -879,11 +884,11 @@ namespace {
             // Explosion threats
             if (pos.blast_on_capture())
             {
-                int evasions = popcount(((attackedBy[Them][pt] & ~pos.pieces(Them)) | pos.pieces(Them, pt)) & ~attackedBy[Us][ALL_PIECES]) * denom;
-                int attacks = popcount((attackedBy[Them][pt] | pos.pieces(Them, pt)) & attackedBy[Us][ALL_PIECES]);
+                int evasions = popcount(((attacked_by(Them, pt) & ~pos.pieces(Them)) | pos.pieces(Them, pt)) & ~attacked_by(Us, ALL_PIECES)) * denom;
+                int attacks = popcount((attacked_by(Them, pt) | pos.pieces(Them, pt)) & attacked_by(Us, ALL_PIECES));
                 int explosions = 0;
 
-                Bitboard bExtBlast = bExt & (attackedBy2[Us] | ~attackedBy[Us][pt]);
+                Bitboard bExtBlast = bExt & (attackedBy2[Us] | ~attacked_by(Us, pt));
                 while (bExtBlast)
                 {
                     Square s = pop_lsb(bExtBlast);
@@ -904,45 +909,45 @@ namespace {
 
     // Squares strongly protected by the enemy, either because they defend the
     // square with a pawn, or because they defend the square twice and we don't.
-    stronglyProtected =  (attackedBy[Them][PAWN] | attackedBy[Them][SHOGI_PAWN] | attackedBy[Them][SOLDIER])
+    stronglyProtected =  (attacked_by(Them, PAWN) | attacked_by(Them, SHOGI_PAWN) | attacked_by(Them, SOLDIER))
                        | (attackedBy2[Them] & ~attackedBy2[Us]);
 
     // Non-pawn enemies, strongly protected
     defended = nonPawnEnemies & stronglyProtected;
 
     // Enemies not strongly protected and under our attack
-    weak = pos.pieces(Them) & ~stronglyProtected & attackedBy[Us][ALL_PIECES];
+    weak = pos.pieces(Them) & ~stronglyProtected & attacked_by(Us, ALL_PIECES);
 
     // Bonus according to the kind of attacking pieces
     if (defended | weak)
     {
-        b = (defended | weak) & (attackedBy[Us][KNIGHT] | attackedBy[Us][BISHOP]);
+        b = (defended | weak) & (attacked_by(Us, KNIGHT) | attacked_by(Us, BISHOP));
         while (b)
             score += ThreatByMinor[type_of(pos.piece_on(pop_lsb(b)))];
 
-        b = weak & attackedBy[Us][ROOK];
+        b = weak & attacked_by(Us, ROOK);
         while (b)
             score += ThreatByRook[type_of(pos.piece_on(pop_lsb(b)))];
 
-        if (weak & attackedBy[Us][KING])
+        if (weak & attacked_by(Us, KING))
             score += ThreatByKing;
 
-        b =  ~attackedBy[Them][ALL_PIECES]
+        b =  ~attacked_by(Them, ALL_PIECES)
            | (nonPawnEnemies & attackedBy2[Us]);
         score += Hanging * popcount(weak & b);
 
         // Additional bonus if weak piece is only protected by a queen
-        score += WeakQueenProtection * popcount(weak & attackedBy[Them][QUEEN]);
+        score += WeakQueenProtection * popcount(weak & attacked_by(Them, QUEEN));
     }
 
     // Bonus for restricting their piece moves
-    b =   attackedBy[Them][ALL_PIECES]
+    b =   attacked_by(Them, ALL_PIECES)
        & ~stronglyProtected
-       &  attackedBy[Us][ALL_PIECES];
+       &  attacked_by(Us, ALL_PIECES);
     score += RestrictedPiece * popcount(b);
 
     // Protected or unattacked squares
-    safe = ~attackedBy[Them][ALL_PIECES] | attackedBy[Us][ALL_PIECES];
+    safe = ~attacked_by(Them, ALL_PIECES) | attacked_by(Us, ALL_PIECES);
 
     // Bonus for attacking enemy pieces with our relatively safe pawns
     b = pos.pieces(Us, PAWN) & safe;
@@ -954,7 +959,7 @@ namespace {
     b |= shift<Up>(b & TRank3BB) & ~pos.pieces();
 
     // Keep only the squares which are relatively safe
-    b &= ~attackedBy[Them][PAWN] & safe;
+    b &= ~attacked_by(Them, PAWN) & safe;
 
     // Bonus for safe pawn threats on the next move
     b = (pawn_attacks_bb<Us>(b) | shift<Up>(shift<Up>(pos.pieces(Us, SHOGI_PAWN, SOLDIER)))) & nonPawnEnemies;
@@ -970,12 +975,12 @@ namespace {
               & ~pos.pieces(Us, PAWN)
               & ~stronglyProtected;
 
-        b = attackedBy[Us][KNIGHT] & attacks_bb<KNIGHT>(s);
+        b = attacked_by(Us, KNIGHT) & attacks_bb<KNIGHT>(s);
 
         score += KnightOnQueen * popcount(b & safe) * (1 + queenImbalance);
 
-        b =  (attackedBy[Us][BISHOP] & attacks_bb<BISHOP>(s, pos.pieces()))
-           | (attackedBy[Us][ROOK  ] & attacks_bb<ROOK  >(s, pos.pieces()));
+        b =  (attacked_by(Us, BISHOP) & attacks_bb<BISHOP>(s, pos.pieces()))
+           | (attacked_by(Us, ROOK) & attacks_bb<ROOK  >(s, pos.pieces()));
 
         score += SliderOnQueen * popcount(b & safe & attackedBy2[Us]) * (1 + queenImbalance);
     }
@@ -1010,7 +1015,7 @@ namespace {
     {
         helpers =  shift<Up>(pos.pieces(Us, PAWN))
                  & ~pos.pieces(Them)
-                 & (~attackedBy2[Them] | attackedBy[Us][ALL_PIECES]);
+                 & (~attackedBy2[Them] | attacked_by(Us, ALL_PIECES));
 
         // Remove blocked candidate passers that don't have help to pass
         b &=  ~blockedPassers
@@ -1050,20 +1055,20 @@ namespace {
                 bb = forward_file_bb(Them, s) & pos.pieces(ROOK, QUEEN);
 
                 if (!(pos.pieces(Them) & bb))
-                    unsafeSquares &= attackedBy[Them][ALL_PIECES] | pos.pieces(Them);
+                    unsafeSquares &= attacked_by(Them, ALL_PIECES) | pos.pieces(Them);
 
                 // If there are no enemy pieces or attacks on passed pawn span, assign a big bonus.
                 // Or if there is some, but they are all attacked by our pawns, assign a bit smaller bonus.
                 // Otherwise assign a smaller bonus if the path to queen is not attacked
                 // and even smaller bonus if it is attacked but block square is not.
                 int k = !unsafeSquares                    ? 36 :
-                !(unsafeSquares & ~attackedBy[Us][PAWN])  ? 30 :
+                !(unsafeSquares & ~attacked_by(Us, PAWN))  ? 30 :
                         !(unsafeSquares & squaresToQueen) ? 17 :
                         !(unsafeSquares & blockSq)        ?  7 :
                                                              0 ;
 
                 // Assign a larger bonus if the block square is defended
-                if ((pos.pieces(Us) & bb) || (attackedBy[Us][ALL_PIECES] & blockSq))
+                if ((pos.pieces(Us) & bb) || (attacked_by(Us, ALL_PIECES) & blockSq))
                     k += 5;
 
                 bonus += make_score(k * w, k * w);
@@ -1112,7 +1117,7 @@ namespace {
 
             Square blockSq = s + Up;
             int d = 2 * std::max(relative_rank(Us, pos.promotion_square(Us, s), pos.max_rank()) - relative_rank(Us, s, pos.max_rank()), 1);
-            d += !!(attackedBy[Them][ALL_PIECES] & ~attackedBy2[Us] & blockSq);
+            d += !!(attacked_by(Them, ALL_PIECES) & ~attackedBy2[Us] & blockSq);
             score += make_score(PieceValue[MG][pt], PieceValue[EG][pt]) / (d * d);
         }
     }
@@ -1148,7 +1153,7 @@ namespace {
     // Find the available squares for our pieces inside the area defined by SpaceMask
     Bitboard safe =   SpaceMask
                    & ~pos.pieces(Us, PAWN)
-                   & ~attackedBy[Them][PAWN];
+                   & ~attacked_by(Them, PAWN);
 
     // Find all squares which are at most three squares behind some friendly pawn
     Bitboard behind = pos.pieces(Us, PAWN);
@@ -1157,13 +1162,13 @@ namespace {
 
     if (pawnsOnly)
     {
-        safe = pos.board_bb() & ((attackedBy2[Us] & ~attackedBy2[Them]) | (attackedBy[Us][PAWN] & ~pos.pieces(Us, PAWN)));
+        safe = pos.board_bb() & ((attackedBy2[Us] & ~attackedBy2[Them]) | (attacked_by(Us, PAWN) & ~pos.pieces(Us, PAWN)));
         behind = 0;
     }
 
     // Compute space score based on the number of safe squares and number of our pieces
     // increased with number of total blocked pawns in position.
-    int bonus = popcount(safe) + popcount(behind & safe & ~attackedBy[Them][ALL_PIECES]);
+    int bonus = popcount(safe) + popcount(behind & safe & ~attacked_by(Them, ALL_PIECES));
     int weight = pos.count<ALL_PIECES>(Us) - 3 + std::min(pe->blocked_count(), 9);
     Score score = make_score(bonus * weight * weight / 16, 0);
 
@@ -1195,9 +1200,9 @@ namespace {
         Bitboard onHold = 0;
         Bitboard onHold2 = 0;
         Bitboard processed = 0;
-        Bitboard blocked = pos.pieces(Us, PAWN) | attackedBy[Them][ALL_PIECES];
+        Bitboard blocked = pos.pieces(Us, PAWN) | attacked_by(Them, ALL_PIECES);
         Bitboard doubleBlocked =  attackedBy2[Them]
-                                | (pos.pieces(Us, PAWN) & (shift<Down>(pos.pieces()) | attackedBy[Them][ALL_PIECES]))
+                                | (pos.pieces(Us, PAWN) & (shift<Down>(pos.pieces()) | attacked_by(Them, ALL_PIECES)))
                                 | (pos.pieces(Them) & pe->pawn_attacks(Them))
                                 | (pawn_attacks_bb<Them>(pos.pieces(Them, PAWN) & pe->pawn_attacks(Them)));
         Bitboard inaccessible = pos.pieces(Us, PAWN) & shift<Down>(pos.pieces(Them, PAWN));
@@ -1271,9 +1276,9 @@ namespace {
             {
                 // Add a bonus according to how close we are to breaking through the pawn wall
                 int dist = 8;
-                Bitboard breakthroughs = attackedBy[Us][ALL_PIECES] & rank_bb(relative_rank(Us, pos.max_rank(), pos.max_rank()));
+                Bitboard breakthroughs = attacked_by(Us, ALL_PIECES) & rank_bb(relative_rank(Us, pos.max_rank(), pos.max_rank()));
                 if (breakthroughs)
-                    dist = attackedBy[Us][QUEEN] & breakthroughs ? 0 : 1;
+                    dist = attacked_by(Us, QUEEN) & breakthroughs ? 0 : 1;
                 else for (File f = FILE_A; f <= pos.max_file(); ++f)
                     dist = std::min(dist, popcount(pos.pieces(PAWN) & file_bb(f)));
                 score += make_score(70, 70) * pos.count<PAWN>(Them) / (1 + dist * dist) / (pos.pieces(Us, QUEEN) ? 2 : 4);
@@ -1506,11 +1511,11 @@ namespace {
         return abs(mg_value(score) + eg_value(score)) / 2 > lazyThreshold + pos.non_pawn_material() / 64;
     };
 
-    if (lazy_skip(LazyThreshold1) && Options["UCI_Variant"] == "chess")
+    if (lazy_skip(LazyThreshold1) && Search::Settings.chessVariant)
         goto make_v;
 
     // Main evaluation begins here
-    std::memset(attackedBy, 0, sizeof(attackedBy));
+    std::memset(attackedBy, 0, pos.variant()->attackIndexCount * sizeof(attackedBy[0]));
     initialize<WHITE>();
     initialize<BLACK>();
 
@@ -1538,7 +1543,7 @@ namespace {
             + passed< WHITE>() - passed< BLACK>()
             + variant<WHITE>() - variant<BLACK>();
 
-    if (lazy_skip(LazyThreshold2) && Options["UCI_Variant"] == "chess")
+    if (lazy_skip(LazyThreshold2) && Search::Settings.chessVariant)
         goto make_v;
 
     score +=  threats<WHITE>() - threats<BLACK>()
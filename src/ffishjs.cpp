@@ -288,7 +288,7 @@ public:
       return true;
     if (claim_draw && pos.is_optional_game_end())
       return true;
-    return MoveList<LEGAL>(pos).size() == 0;
+    return !pos.has_any_legal_move();
   }
 
   std::string result() const {
@@ -304,7 +304,7 @@ public:
         result = VALUE_DRAW;
       }
     }
-    if (!gameEnd && MoveList<LEGAL>(pos).size() == 0) {
+    if (!gameEnd && !pos.has_any_legal_move()) {
       gameEnd = true;
       result = pos.checkers() ? pos.checkmate_value() : pos.stalemate_value();
     }
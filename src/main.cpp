@@ -49,6 +49,7 @@ int main(int argc, char* argv[]) {
   Position::init();
   Bitbases::init();
   Endgames::init();
+  Endgames::init(variants.find(Options["UCI_Variant"])->second);
   Threads.set(size_t(Options["Threads"]));
   Search::clear(); // After threads are up
   Eval::NNUE::init();
@@ -56,6 +57,7 @@ int main(int argc, char* argv[]) {
   UCI::loop(argc, argv);
 
   Threads.set(0);
+  Bitbases::clear();
   variants.clear_all();
   pieceMap.clear_all();
   delete XBoard::stateMachine;
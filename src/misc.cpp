@@ -301,6 +301,22 @@ void dbg_print() {
 }
 
 
+/// hot_counter_name() returns the label of a hot path counter for printing
+
+std::string hot_counter_name(HotCounter c) {
+
+  constexpr const char* Names[HOT_COUNTER_NB] = {
+    "NNUE incremental", "NNUE refresh", "Illegal moves", "Chase checks",
+    "Stage TT move", "Stage captures", "Stage quiets", "Stage bad captures",
+    "Stage evasions", "Stage qsearch checks",
+    "Futility pruning", "Null move cutoffs", "ProbCut cutoffs", "Shallow pruning",
+    "LMR reductions", "Qsearch pruning"
+  };
+
+  return Names[c];
+}
+
+
 /// Used to serialize access to std::cout to avoid multiple threads writing at
 /// the same time.
 
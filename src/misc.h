@@ -21,8 +21,12 @@
 
 #include <cassert>
 #include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
 #include <ostream>
 #include <string>
+#include <type_traits>
 #include <vector>
 #include <cstdint>
 
@@ -44,6 +48,31 @@ void dbg_hit_on(bool c, bool b);
 void dbg_mean_of(int v);
 void dbg_print();
 
+/// Hot path counters used for profiling. They are only compiled in with
+/// USE_COUNTERS ('make counters=yes'). Each search thread owns one set, so
+/// counting is a plain non-atomic increment. The 'stats' command prints them.
+
+#ifdef USE_COUNTERS
+constexpr bool UseCounters = true;
+#else
+constexpr bool UseCounters = false;
+#endif
+
+enum HotCounter {
+  CNT_NNUE_INCREMENTAL, CNT_NNUE_REFRESH, CNT_ILLEGAL, CNT_CHASED,
+  CNT_STAGE_TT, CNT_STAGE_CAPTURES, CNT_STAGE_QUIETS, CNT_STAGE_BAD_CAPTURES,
+  CNT_STAGE_EVASIONS, CNT_STAGE_QCHECKS,
+  CNT_FUTILITY, CNT_NULL_MOVE, CNT_PROBCUT, CNT_SHALLOW_PRUNING, CNT_LMR, CNT_QS_PRUNING,
+  HOT_COUNTER_NB
+};
+
+struct HotCounters {
+  void inc(HotCounter c) { if (UseCounters) ++count[c]; }
+  uint64_t count[HOT_COUNTER_NB];
+};
+
+std::string hot_counter_name(HotCounter c);
+
 typedef std::chrono::milliseconds::rep TimePoint; // A value in milliseconds
 static_assert(sizeof(TimePoint) == sizeof(int64_t), "TimePoint should be 64 bits");
 inline TimePoint now() {
@@ -51,12 +80,49 @@ inline TimePoint now() {
         (std::chrono::steady_clock::now().time_since_epoch()).count();
 }
 
+/// HashTable is indexed by the low bits of the key. It has Size entries until
+/// it is resized to another power of two, and it is allocated with large pages
+/// when they are available.
+
 template<class Entry, int Size>
 struct HashTable {
-  Entry* operator[](Key key) { return &table[(uint32_t)key & (Size - 1)]; }
+  static_assert(std::is_trivially_copyable<Entry>::value, "Entries are cleared with memset");
+
+  static constexpr size_t DefaultSize = Size;
+
+  HashTable() { resize(Size); }
+  HashTable(const HashTable&) = delete;
+  HashTable& operator=(const HashTable&) = delete;
+  ~HashTable() { aligned_large_pages_free(table); }
+
+  Entry* operator[](Key key) { return &table[key & mask]; }
+
+  // Resize to the largest power of two number of entries not above the given one
+  void resize(size_t entries) {
+
+    size_t size = 1;
+    while (size * 2 <= entries)
+        size *= 2;
+
+    if (table && size == mask + 1)
+        return;
+
+    aligned_large_pages_free(table);
+    table = static_cast<Entry*>(aligned_large_pages_alloc(size * sizeof(Entry)));
+    if (!table)
+    {
+        std::cerr << "Failed to allocate " << size * sizeof(Entry) / 1024
+                  << "kB for an evaluation hash table." << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    std::memset(table, 0, size * sizeof(Entry));
+    mask = size - 1;
+  }
 
 private:
-  std::vector<Entry> table = std::vector<Entry>(Size); // Allocate on the heap
+  Entry* table = nullptr;
+  size_t mask = 0;
 };
 
 
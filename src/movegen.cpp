@@ -426,10 +426,26 @@ namespace {
   }
 
 
+  template<Color Us, GenType Type>
+  ExtMove* generate_hand_moves(const Position& pos, ExtMove* moveList, Bitboard target) {
+
+    // generate drops
+    if (pos.piece_drops() && (pos.can_drop(Us, ALL_PIECES) || pos.two_boards()))
+        for (PieceSet ps = pos.piece_types(); ps;)
+            moveList = generate_drops<Us, Type>(pos, moveList, pop_lsb(ps), target & ~pos.pieces(~Us));
+    // generate exchange
+    if (pos.capture_type() == PRISON && pos.has_exchange())
+        for (PieceSet ps = pos.piece_types(); ps;)
+            moveList = generate_exchanges<Us, Type>(pos, moveList, pop_lsb(ps), target & ~pos.pieces(~Us));
+
+    return moveList;
+  }
+
+
   template<Color Us, GenType Type>
   ExtMove* generate_all(const Position& pos, ExtMove* moveList) {
 
-    static_assert(Type != LEGAL, "Unsupported type in generate_all()");
+    static_assert(Type != LEGAL && Type != DROPS, "Unsupported type in generate_all()");
 
     constexpr bool Checks = Type == QUIET_CHECKS; // Reduce template instantiations
     const Square ksq = pos.count<KING>(Us) ? pos.square<KING>(Us) : SQ_NONE;
@@ -459,14 +475,8 @@ namespace {
         moveList = generate_pawn_moves<Us, Type>(pos, moveList, target);
         for (PieceSet ps = pos.piece_types() & ~(piece_set(PAWN) | KING); ps;)
             moveList = generate_moves<Us, Type>(pos, moveList, pop_lsb(ps), target);
-        // generate drops
-        if (pos.piece_drops() && Type != CAPTURES && (pos.can_drop(Us, ALL_PIECES) || pos.two_boards()))
-            for (PieceSet ps = pos.piece_types(); ps;)
-                moveList = generate_drops<Us, Type>(pos, moveList, pop_lsb(ps), target & ~pos.pieces(~Us));
-        // generate exchange
-        if (pos.capture_type() == PRISON && Type != CAPTURES && pos.has_exchange())
-            for (PieceSet ps = pos.piece_types(); ps;)
-                moveList = generate_exchanges<Us, Type>(pos, moveList, pop_lsb(ps), target & ~pos.pieces(~Us));
+        if (Type != CAPTURES && Type != BOARD_QUIETS)
+            moveList = generate_hand_moves<Us, Type>(pos, moveList, target);
 
         // Castling with non-king piece
         if (!pos.count<KING>(Us) && Type != CAPTURES && pos.can_castle(Us & ANY_CASTLING))
@@ -522,7 +532,7 @@ namespace {
         if (pos.pass(Us))
             *moveList++ = make<SPECIAL>(ksq, ksq);
 
-        if ((Type == QUIETS || Type == NON_EVASIONS) && pos.can_castle(Us & ANY_CASTLING))
+        if ((Type == QUIETS || Type == BOARD_QUIETS || Type == NON_EVASIONS) && pos.can_castle(Us & ANY_CASTLING))
             for (CastlingRights cr : { Us & KING_SIDE, Us & QUEEN_SIDE } )
                 if (!pos.castling_impeded(cr) && pos.can_castle(cr))
                     moveList = make_move_and_gating<CASTLING>(pos, moveList, Us,ksq, pos.castling_rook_square(cr));
@@ -539,13 +549,14 @@ namespace {
 /// <EVASIONS>     Generates all pseudo-legal check evasions when the side to move is in check
 /// <QUIET_CHECKS> Generates all pseudo-legal non-captures giving check, except castling and promotions
 /// <NON_EVASIONS> Generates all pseudo-legal captures and non-captures
+/// <BOARD_QUIETS> Generates all pseudo-legal non-captures except moves from the hand or prison
 ///
 /// Returns a pointer to the end of the move list.
 
 template<GenType Type>
 ExtMove* generate(const Position& pos, ExtMove* moveList) {
 
-  static_assert(Type != LEGAL, "Unsupported type in generate()");
+  static_assert(Type != LEGAL && Type != DROPS, "Unsupported type in generate()");
   assert((Type == EVASIONS) == (bool)pos.checkers());
 
   Color us = pos.side_to_move();
@@ -560,6 +571,22 @@ template ExtMove* generate<QUIETS>(const Position&, ExtMove*);
 template ExtMove* generate<EVASIONS>(const Position&, ExtMove*);
 template ExtMove* generate<QUIET_CHECKS>(const Position&, ExtMove*);
 template ExtMove* generate<NON_EVASIONS>(const Position&, ExtMove*);
+template ExtMove* generate<BOARD_QUIETS>(const Position&, ExtMove*);
+
+
+/// generate<DROPS> generates the pseudo-legal drops and exchanges that complete
+/// generate<BOARD_QUIETS> to generate<QUIETS>, so that callers can stop early.
+
+template<>
+ExtMove* generate<DROPS>(const Position& pos, ExtMove* moveList) {
+
+  assert(!pos.checkers());
+
+  Bitboard target = ~pos.pieces() & pos.board_bb();
+
+  return pos.side_to_move() == WHITE ? generate_hand_moves<WHITE, QUIETS>(pos, moveList, target)
+                                     : generate_hand_moves<BLACK, QUIETS>(pos, moveList, target);
+}
 
 
 /// generate<LEGAL> generates all the legal moves in the given position
@@ -40,6 +40,10 @@ enum GenType {
   EVASIONS,
   //Moves that are not check evasion moves
   NON_EVASIONS,
+  //QUIETS without drops and exchanges of pieces in hand or prison
+  BOARD_QUIETS,
+  //Drops and exchanges of pieces in hand or prison, the rest of QUIETS
+  DROPS,
   //Moves that are legal
   LEGAL
 };
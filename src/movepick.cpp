@@ -19,6 +19,7 @@
 #include <cassert>
 
 #include "movepick.h"
+#include "thread.h"
 
 namespace Stockfish {
 
@@ -164,6 +165,7 @@ top:
   case EVASION_TT:
   case QSEARCH_TT:
   case PROBCUT_TT:
+      pos.this_thread()->counters.inc(CNT_STAGE_TT);
       ++stage;
       assert(pos.legal(ttMove) == MoveList<LEGAL>(pos).contains(ttMove) || pos.virtual_drop(ttMove) || exchange_piece(ttMove));
       return ttMove;
@@ -171,6 +173,7 @@ top:
   case CAPTURE_INIT:
   case PROBCUT_INIT:
   case QCAPTURE_INIT:
+      pos.this_thread()->counters.inc(CNT_STAGE_CAPTURES);
       cur = endBadCaptures = moves;
       endMoves = generate<CAPTURES>(pos, cur);
 
@@ -208,6 +211,7 @@ top:
   case QUIET_INIT:
       if (!skipQuiets && !(pos.must_capture() && pos.has_capture()))
       {
+          pos.this_thread()->counters.inc(CNT_STAGE_QUIETS);
           cur = endBadCaptures;
           endMoves = generate<QUIETS>(pos, cur);
 
@@ -229,6 +233,9 @@ top:
       cur = moves;
       endMoves = endBadCaptures;
 
+      if (endMoves > cur)
+          pos.this_thread()->counters.inc(CNT_STAGE_BAD_CAPTURES);
+
       ++stage;
       [[fallthrough]];
 
@@ -236,6 +243,7 @@ top:
       return select<Next>([](){ return true; });
 
   case EVASION_INIT:
+      pos.this_thread()->counters.inc(CNT_STAGE_EVASIONS);
       cur = moves;
       endMoves = generate<EVASIONS>(pos, cur);
 
@@ -262,6 +270,7 @@ top:
       [[fallthrough]];
 
   case QCHECK_INIT:
+      pos.this_thread()->counters.inc(CNT_STAGE_QCHECKS);
       cur = moves;
       endMoves = generate<QUIET_CHECKS>(pos, cur);
 
@@ -26,6 +26,7 @@
 
 #include "../evaluate.h"
 #include "../position.h"
+#include "../thread.h"
 #include "../misc.h"
 #include "../uci.h"
 #include "../types.h"
@@ -34,16 +35,40 @@
 
 namespace Stockfish::Eval::NNUE {
 
-  // Input feature converter
-  LargePagePtr<FeatureTransformer> featureTransformer;
+  // Parameters of a network of the given architecture
+  template <typename Arch>
+  struct Model {
 
-  // Evaluation function
-  AlignedPtr<Network> network[LayerStacks];
+    // Input feature converter
+    LargePagePtr<ArchFeatureTransformer<Arch>> featureTransformer;
+
+    // Evaluation function
+    AlignedPtr<typename Arch::Network> network[LayerStacks];
+  };
+
+  Model<DefaultArchitecture> defaultModel;
+  Model<SmallArchitecture> smallModel;
+  Model<QuantizedArchitecture> quantizedModel;
+
+  // Architecture of the loaded network
+  enum ArchitectureId { DEFAULT_ARCH, SMALL_ARCH, QUANTIZED_ARCH };
+  ArchitectureId architecture = DEFAULT_ARCH;
 
   // Evaluation function file name
   std::string fileName;
   std::string netDescription;
 
+  // Call the given function with the model of the loaded network
+  template <typename Function>
+  auto with_model(Function&& f) {
+    switch (architecture)
+    {
+    case SMALL_ARCH:     return f(smallModel);
+    case QUANTIZED_ARCH: return f(quantizedModel);
+    default:             return f(defaultModel);
+    }
+  }
+
   namespace Detail {
 
   // Initialize the evaluation function parameters
@@ -83,11 +108,21 @@ namespace Stockfish::Eval::NNUE {
   }  // namespace Detail
 
   // Initialize the evaluation function parameters
-  void initialize() {
+  template <typename Arch>
+  void initialize(Model<Arch>& model) {
 
-    Detail::initialize(featureTransformer);
+    Detail::initialize(model.featureTransformer);
     for (std::size_t i = 0; i < LayerStacks; ++i)
-      Detail::initialize(network[i]);
+      Detail::initialize(model.network[i]);
+  }
+
+  // Free the parameters of an architecture which is not in use
+  template <typename Arch>
+  void release(Model<Arch>& model) {
+
+    model.featureTransformer.reset();
+    for (std::size_t i = 0; i < LayerStacks; ++i)
+      model.network[i].reset();
   }
 
   // Read network header
@@ -115,29 +150,53 @@ namespace Stockfish::Eval::NNUE {
   }
 
   // Read network parameters
+  template <typename Arch>
+  bool read_parameters(std::istream& stream, Model<Arch>& model, ArchitectureId id) {
+
+    // Keep only the parameters of the architecture in use
+    release(defaultModel);
+    release(smallModel);
+    release(quantizedModel);
+    architecture = id;
+
+    initialize(model);
+    if (!Detail::read_parameters(stream, *model.featureTransformer)) return false;
+    for (std::size_t i = 0; i < LayerStacks; ++i)
+      if (!Detail::read_parameters(stream, *(model.network[i]))) return false;
+    return stream && stream.peek() == std::ios::traits_type::eof();
+  }
+
+  // Read network parameters, with the architecture given by the header
   bool read_parameters(std::istream& stream) {
 
     std::uint32_t hashValue;
     if (!read_header(stream, &hashValue, &netDescription)) return false;
-    if (hashValue != HashValue) return false;
-    if (!Detail::read_parameters(stream, *featureTransformer)) return false;
-    for (std::size_t i = 0; i < LayerStacks; ++i)
-      if (!Detail::read_parameters(stream, *(network[i]))) return false;
-    return stream && stream.peek() == std::ios::traits_type::eof();
+    if (hashValue == HashValue<DefaultArchitecture>)
+      return read_parameters(stream, defaultModel, DEFAULT_ARCH);
+    if (hashValue == HashValue<SmallArchitecture>)
+      return read_parameters(stream, smallModel, SMALL_ARCH);
+    if (hashValue == HashValue<QuantizedArchitecture>)
+      return read_parameters(stream, quantizedModel, QUANTIZED_ARCH);
+    return false;
   }
 
   // Write network parameters
-  bool write_parameters(std::ostream& stream) {
+  template <typename Arch>
+  bool write_parameters(std::ostream& stream, const Model<Arch>& model) {
 
-    if (!write_header(stream, HashValue, netDescription)) return false;
-    if (!Detail::write_parameters(stream, *featureTransformer)) return false;
+    if (!write_header(stream, HashValue<Arch>, netDescription)) return false;
+    if (!Detail::write_parameters(stream, *model.featureTransformer)) return false;
     for (std::size_t i = 0; i < LayerStacks; ++i)
-      if (!Detail::write_parameters(stream, *(network[i]))) return false;
+      if (!Detail::write_parameters(stream, *(model.network[i]))) return false;
     return (bool)stream;
   }
 
-  // Evaluation function. Perform differential calculation.
-  Value evaluate(const Position& pos, bool adjusted) {
+  // Evaluate the position with the network of the given architecture
+  template <typename Arch>
+  static Value evaluate(const Model<Arch>& model, const Position& pos, bool adjusted) {
+
+    using FeatureTransformer = ArchFeatureTransformer<Arch>;
+    using Network = typename Arch::Network;
 
     // We manually align the arrays on the stack because with gcc < 9.3
     // overaligning stack variables with alignas() doesn't work correctly.
@@ -161,8 +220,8 @@ namespace Stockfish::Eval::NNUE {
     ASSERT_ALIGNED(buffer, alignment);
 
     const std::size_t bucket = std::min((pos.count<ALL_PIECES>() - 1) * 8 / currentNnueVariant->nnueMaxPieces, 7);
-    const auto psqt = featureTransformer->transform(pos, transformedFeatures, bucket);
-    const auto output = network[bucket]->propagate(transformedFeatures, buffer);
+    const auto psqt = model.featureTransformer->transform(pos, transformedFeatures, bucket);
+    const auto output = model.network[bucket]->propagate(transformedFeatures, buffer);
 
     int materialist = psqt;
     int positional  = output[0];
@@ -178,6 +237,12 @@ namespace Stockfish::Eval::NNUE {
     return static_cast<Value>( sum / OutputScale );
   }
 
+  // Evaluation function. Perform differential calculation.
+  Value evaluate(const Position& pos, bool adjusted) {
+
+    return with_model([&](const auto& model) { return evaluate(model, pos, adjusted); });
+  }
+
   struct NnueEvalTrace {
     static_assert(LayerStacks == PSQTBuckets);
 
@@ -186,7 +251,11 @@ namespace Stockfish::Eval::NNUE {
     std::size_t correctBucket;
   };
 
-  static NnueEvalTrace trace_evaluate(const Position& pos) {
+  template <typename Arch>
+  static NnueEvalTrace trace_evaluate(const Model<Arch>& model, const Position& pos) {
+
+    using FeatureTransformer = ArchFeatureTransformer<Arch>;
+    using Network = typename Arch::Network;
 
     // We manually align the arrays on the stack because with gcc < 9.3
     // overaligning stack variables with alignas() doesn't work correctly.
@@ -212,8 +281,8 @@ namespace Stockfish::Eval::NNUE {
     NnueEvalTrace t{};
     t.correctBucket = std::min((pos.count<ALL_PIECES>() - 1) * 8 / currentNnueVariant->nnueMaxPieces, 7);
     for (std::size_t bucket = 0; bucket < LayerStacks; ++bucket) {
-      const auto psqt = featureTransformer->transform(pos, transformedFeatures, bucket);
-      const auto output = network[bucket]->propagate(transformedFeatures, buffer);
+      const auto psqt = model.featureTransformer->transform(pos, transformedFeatures, bucket);
+      const auto output = model.network[bucket]->propagate(transformedFeatures, buffer);
 
       int materialist = psqt;
       int positional  = output[0];
@@ -358,7 +427,7 @@ namespace Stockfish::Eval::NNUE {
         ss << board[row] << '\n';
     ss << '\n';
 
-    auto t = trace_evaluate(pos);
+    auto t = with_model([&](const auto& model) { return trace_evaluate(model, pos); });
 
     ss << " NNUE network contributions "
        << (pos.side_to_move() == WHITE ? "(White to move)" : "(Black to move)") << std::endl
@@ -395,7 +464,6 @@ namespace Stockfish::Eval::NNUE {
   // Load eval, from a file stream or a memory stream
   bool load_eval(std::string name, std::istream& stream) {
 
-    initialize();
     fileName = name;
     return read_parameters(stream);
   }
@@ -406,7 +474,7 @@ namespace Stockfish::Eval::NNUE {
     if (fileName.empty())
       return false;
 
-    return write_parameters(stream);
+    return with_model([&](const auto& model) { return write_parameters(stream, model); });
   }
 
   /// Save eval, to a file given by its name
@@ -27,9 +27,15 @@
 
 namespace Stockfish::Eval::NNUE {
 
+  // Feature transformer of an architecture
+  template <typename Arch>
+  using ArchFeatureTransformer =
+      FeatureTransformer<Arch::TransformedDimensions, typename Arch::TransformerWeightType>;
+
   // Hash value of evaluation function structure
+  template <typename Arch>
   constexpr std::uint32_t HashValue =
-      FeatureTransformer::get_hash_value() ^ Network::get_hash_value();
+      ArchFeatureTransformer<Arch>::get_hash_value() ^ Arch::Network::get_hash_value();
 
   // Deleter for automating release of memory area
   template <typename T>
@@ -101,8 +101,11 @@ namespace Stockfish::Eval::NNUE::Features {
     return st->dirtyPiece.dirty_num;
   }
 
+  // A refresh also has to add one feature per piece in hand, so the estimate
+  // includes the pockets. Drops and captures to hand only change a single hand
+  // feature each and are cheap to update incrementally.
   int HalfKAv2Variants::refresh_cost(const Position& pos) {
-    return pos.count<ALL_PIECES>();
+    return pos.count<ALL_PIECES>() + (pos.nnue_use_pockets() ? std::max(pos.count_in_hand(ALL_PIECES), 0) : 0);
   }
 
   bool HalfKAv2Variants::requires_refresh(StateInfo* st, Color perspective, const Position& pos) {
@@ -26,6 +26,22 @@
 
 namespace Stockfish::Eval::NNUE::Layers {
 
+  // Offsets and number of the set bits of every byte, used to turn
+  // bit sets of non-zero inputs into index lists
+  struct NnzLookupTable {
+    std::uint16_t offsets[256][8];
+    std::uint8_t count[256];
+  };
+
+  inline constexpr NnzLookupTable NnzLookup = [] {
+    NnzLookupTable t{};
+    for (int b = 0; b < 256; ++b)
+        for (int i = 0; i < 8; ++i)
+            if (b & (1 << i))
+                t.offsets[b][t.count[b]++] = std::uint16_t(i);
+    return t;
+  }();
+
   // Affine transformation layer
   template <typename PreviousLayer, IndexType OutDims>
   class AffineTransform {
@@ -47,6 +63,10 @@ namespace Stockfish::Eval::NNUE::Layers {
     static constexpr const IndexType OutputSimdWidth = SimdWidth / 4;
 #endif
 
+    // Skip the all-zero input chunks of the wide first hidden layer. Only done
+    // with VNNI, where dpbusd adds single chunks without intermediate saturation.
+    static constexpr bool SparseInput = InputDimensions >= 512;
+
     // Size of forward propagation buffer used in this layer
     static constexpr std::size_t SelfBufferSize =
         ceil_to_multiple(OutputDimensions * sizeof(OutputType), CacheLineSize);
@@ -123,6 +143,10 @@ namespace Stockfish::Eval::NNUE::Layers {
         return _mm512_reduce_add_epi32(sum) + bias;
       };
 
+      [[maybe_unused]] auto m512_nnz = [](__m512i in) -> unsigned {
+        return _mm512_test_epi32_mask(in, in);
+      };
+
       [[maybe_unused]] auto m512_add_dpbusd_epi32 = [=](__m512i& acc, __m512i a, __m512i b) {
 #if defined (USE_VNNI)
         acc = _mm512_dpbusd_epi32(acc, a, b);
@@ -165,6 +189,11 @@ namespace Stockfish::Eval::NNUE::Layers {
         return _mm_cvtsi128_si32(sum128) + bias;
       };
 
+      // Inputs are in [0, 127], so a 32-bit chunk is non-zero iff it is positive
+      [[maybe_unused]] auto m256_nnz = [](__m256i in) -> unsigned {
+        return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(in, _mm256_setzero_si256())));
+      };
+
       [[maybe_unused]] auto m256_add_dpbusd_epi32 = [=](__m256i& acc, __m256i a, __m256i b) {
 #if defined (USE_VNNI)
         acc = _mm256_dpbusd_epi32(acc, a, b);
@@ -231,20 +260,25 @@ namespace Stockfish::Eval::NNUE::Layers {
       using vec_t = __m512i;
       #define vec_setzero _mm512_setzero_si512
       #define vec_set_32 _mm512_set1_epi32
+      #define vec_add_32 _mm512_add_epi32
       auto& vec_add_dpbusd_32 = m512_add_dpbusd_epi32;
       auto& vec_add_dpbusd_32x4 = m512_add_dpbusd_epi32x4;
       auto& vec_hadd = m512_hadd;
+      [[maybe_unused]] auto& vec_nnz = m512_nnz;
 #elif defined (USE_AVX2)
       using vec_t = __m256i;
       #define vec_setzero _mm256_setzero_si256
       #define vec_set_32 _mm256_set1_epi32
+      #define vec_add_32 _mm256_add_epi32
       auto& vec_add_dpbusd_32 = m256_add_dpbusd_epi32;
       auto& vec_add_dpbusd_32x4 = m256_add_dpbusd_epi32x4;
       auto& vec_hadd = m256_hadd;
+      [[maybe_unused]] auto& vec_nnz = m256_nnz;
 #elif defined (USE_SSSE3)
       using vec_t = __m128i;
       #define vec_setzero _mm_setzero_si128
       #define vec_set_32 _mm_set1_epi32
+      #define vec_add_32 _mm_add_epi32
       auto& vec_add_dpbusd_32 = m128_add_dpbusd_epi32;
       auto& vec_add_dpbusd_32x4 = m128_add_dpbusd_epi32x4;
       auto& vec_hadd = m128_hadd;
@@ -267,20 +301,82 @@ namespace Stockfish::Eval::NNUE::Layers {
 
           const auto input32 = reinterpret_cast<const std::int32_t*>(input);
           vec_t* outptr = reinterpret_cast<vec_t*>(output);
-          std::memcpy(output, biases, OutputDimensions * sizeof(OutputType));
 
-          for (int i = 0; i < (int)NumChunks - 3; i += 4)
+#if defined (USE_VNNI)
+          if constexpr (SparseInput)
+          {
+              constexpr IndexType ChunksPerVector = sizeof(vec_t) / 4;
+              constexpr IndexType NumRegs = OutputDimensions / OutputSimdWidth;
+              static_assert(NumChunks % 64 == 0 && ChunksPerVector <= 64);
+
+              // Collect the non-zero 32-bit input chunks as a bit set
+              std::uint64_t nnzBits[NumChunks / 64];
+              for (IndexType w = 0; w < NumChunks / 64; ++w)
+              {
+                  std::uint64_t bits = 0;
+                  for (IndexType k = 0; k < 64 / ChunksPerVector; ++k)
+                      bits |= std::uint64_t(vec_nnz(inputVector[w * 64 / ChunksPerVector + k])) << (k * ChunksPerVector);
+                  nnzBits[w] = bits;
+              }
+
+              // Turn the bit set into a list of chunk indices, eight bits at a time
+              std::uint16_t nnz[NumChunks + 8];
+              IndexType count = 0;
+              for (IndexType b = 0; b < NumChunks / 8; ++b)
+              {
+                  const unsigned byte = (nnzBits[b / 8] >> (b % 8 * 8)) & 0xFF;
+                  for (IndexType c = 0; c < 8; ++c)
+                      nnz[count + c] = std::uint16_t(b * 8 + NnzLookup.offsets[byte][c]);
+                  count += NnzLookup.count[byte];
+              }
+
+              // Accumulate the weight columns of the listed chunks in registers,
+              // alternating between two sets to shorten the dependency chains
+              vec_t acc[2][NumRegs];
+              const auto biasvec = reinterpret_cast<const vec_t*>(biases);
+              for (IndexType j = 0; j < NumRegs; ++j)
+              {
+                  acc[0][j] = biasvec[j];
+                  acc[1][j] = vec_setzero();
+              }
+
+              auto add_chunk = [&](vec_t* a, IndexType i) {
+                  const vec_t in = vec_set_32(input32[i]);
+                  const auto col = reinterpret_cast<const vec_t*>(&weights[i * OutputDimensions * 4]);
+                  for (IndexType j = 0; j < NumRegs; ++j)
+                      vec_add_dpbusd_32(a[j], in, col[j]);
+              };
+
+              IndexType n = 0;
+              for ( ; n + 1 < count; n += 2)
+              {
+                  add_chunk(acc[0], nnz[n]);
+                  add_chunk(acc[1], nnz[n + 1]);
+              }
+              if (n < count)
+                  add_chunk(acc[0], nnz[n]);
+
+              for (IndexType j = 0; j < NumRegs; ++j)
+                  outptr[j] = vec_add_32(acc[0][j], acc[1][j]);
+          }
+          else
+#endif
           {
-              const vec_t in0 = vec_set_32(input32[i + 0]);
-              const vec_t in1 = vec_set_32(input32[i + 1]);
-              const vec_t in2 = vec_set_32(input32[i + 2]);
-              const vec_t in3 = vec_set_32(input32[i + 3]);
-              const auto col0 = reinterpret_cast<const vec_t*>(&weights[(i + 0) * OutputDimensions * 4]);
-              const auto col1 = reinterpret_cast<const vec_t*>(&weights[(i + 1) * OutputDimensions * 4]);
-              const auto col2 = reinterpret_cast<const vec_t*>(&weights[(i + 2) * OutputDimensions * 4]);
-              const auto col3 = reinterpret_cast<const vec_t*>(&weights[(i + 3) * OutputDimensions * 4]);
-              for (int j = 0; j * OutputSimdWidth < OutputDimensions; ++j)
-                  vec_add_dpbusd_32x4(outptr[j], in0, col0[j], in1, col1[j], in2, col2[j], in3, col3[j]);
+              std::memcpy(output, biases, OutputDimensions * sizeof(OutputType));
+
+              for (int i = 0; i < (int)NumChunks - 3; i += 4)
+              {
+                  const vec_t in0 = vec_set_32(input32[i + 0]);
+                  const vec_t in1 = vec_set_32(input32[i + 1]);
+                  const vec_t in2 = vec_set_32(input32[i + 2]);
+                  const vec_t in3 = vec_set_32(input32[i + 3]);
+                  const auto col0 = reinterpret_cast<const vec_t*>(&weights[(i + 0) * OutputDimensions * 4]);
+                  const auto col1 = reinterpret_cast<const vec_t*>(&weights[(i + 1) * OutputDimensions * 4]);
+                  const auto col2 = reinterpret_cast<const vec_t*>(&weights[(i + 2) * OutputDimensions * 4]);
+                  const auto col3 = reinterpret_cast<const vec_t*>(&weights[(i + 3) * OutputDimensions * 4]);
+                  for (int j = 0; j * OutputSimdWidth < OutputDimensions; ++j)
+                      vec_add_dpbusd_32x4(outptr[j], in0, col0[j], in1, col1[j], in2, col2[j], in3, col3[j]);
+              }
           }
       }
       else if constexpr (OutputDimensions == 1)
@@ -34,26 +34,39 @@ namespace Stockfish::Eval::NNUE {
   // Input features used in evaluation function
   using FeatureSet = Features::HalfKAv2Variants;
 
-  // Number of input feature dimensions after conversion
+  // Number of input feature dimensions after conversion of the widest
+  // compiled architecture, which sizes the accumulators
   constexpr IndexType TransformedFeatureDimensions = 512;
   constexpr IndexType PSQTBuckets = 8;
   constexpr IndexType LayerStacks = 8;
 
-  namespace Layers {
-
-    // Define network structure
-    using InputLayer = InputSlice<TransformedFeatureDimensions * 2>;
-    using HiddenLayer1 = ClippedReLU<AffineTransform<InputLayer, 16>>;
-    using HiddenLayer2 = ClippedReLU<AffineTransform<HiddenLayer1, 32>>;
-    using OutputLayer = AffineTransform<HiddenLayer2, 1>;
-
-  }  // namespace Layers
-
-  using Network = Layers::OutputLayer;
-
-  static_assert(TransformedFeatureDimensions % MaxSimdWidth == 0, "");
-  static_assert(Network::OutputDimensions == 1, "");
-  static_assert(std::is_same<Network::OutputType, std::int32_t>::value, "");
+  // Network structure for a given number of transformed feature dimensions
+  // and type of the feature transformer weights
+  template <IndexType TransformedFeatureDims, typename TransformerWeightT = std::int16_t>
+  struct Architecture {
+
+    static constexpr IndexType TransformedDimensions = TransformedFeatureDims;
+    using TransformerWeightType = TransformerWeightT;
+
+    using InputLayer = Layers::InputSlice<TransformedDimensions * 2>;
+    using HiddenLayer1 = Layers::ClippedReLU<Layers::AffineTransform<InputLayer, 16>>;
+    using HiddenLayer2 = Layers::ClippedReLU<Layers::AffineTransform<HiddenLayer1, 32>>;
+    using OutputLayer = Layers::AffineTransform<HiddenLayer2, 1>;
+
+    using Network = OutputLayer;
+
+    static_assert(TransformedDimensions <= TransformedFeatureDimensions, "");
+    static_assert(TransformedDimensions % MaxSimdWidth == 0, "");
+    static_assert(Network::OutputDimensions == 1, "");
+    static_assert(std::is_same<typename Network::OutputType, std::int32_t>::value, "");
+  };
+
+  // Compiled architectures. The hash value in the header of a network file
+  // selects the one it is evaluated with, so that small variants can use
+  // narrower and faster networks.
+  using DefaultArchitecture = Architecture<TransformedFeatureDimensions>;
+  using SmallArchitecture = Architecture<TransformedFeatureDimensions / 2>;
+  using QuantizedArchitecture = Architecture<TransformedFeatureDimensions, std::int8_t>;
 
 }  // namespace Stockfish::Eval::NNUE
 
@@ -52,6 +52,9 @@ namespace Stockfish::Eval::NNUE {
   #define vec_add_psqt_32(a,b) _mm256_add_epi32(a,b)
   #define vec_sub_psqt_32(a,b) _mm256_sub_epi32(a,b)
   #define vec_zero_psqt() _mm256_setzero_si256()
+  #define vec_set_16(a) _mm512_set1_epi16(a)
+  #define vec_mul_16(a,b) _mm512_mullo_epi16(a,b)
+  #define vec_load_8_16(a) _mm512_cvtepi8_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a)))
   #define NumRegistersSIMD 32
 
   #elif USE_AVX2
@@ -66,6 +69,9 @@ namespace Stockfish::Eval::NNUE {
   #define vec_add_psqt_32(a,b) _mm256_add_epi32(a,b)
   #define vec_sub_psqt_32(a,b) _mm256_sub_epi32(a,b)
   #define vec_zero_psqt() _mm256_setzero_si256()
+  #define vec_set_16(a) _mm256_set1_epi16(a)
+  #define vec_mul_16(a,b) _mm256_mullo_epi16(a,b)
+  #define vec_load_8_16(a) _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a)))
   #define NumRegistersSIMD 16
 
   #elif USE_SSE2
@@ -80,6 +86,10 @@ namespace Stockfish::Eval::NNUE {
   #define vec_add_psqt_32(a,b) _mm_add_epi32(a,b)
   #define vec_sub_psqt_32(a,b) _mm_sub_epi32(a,b)
   #define vec_zero_psqt() _mm_setzero_si128()
+  #define vec_set_16(a) _mm_set1_epi16(a)
+  #define vec_mul_16(a,b) _mm_mullo_epi16(a,b)
+  #define vec_load_8_16(a) _mm_srai_epi16(_mm_unpacklo_epi8(_mm_setzero_si128(), \
+                               _mm_loadl_epi64(reinterpret_cast<const __m128i*>(a))), 8)
   #define NumRegistersSIMD (Is64Bit ? 16 : 8)
 
   #elif USE_MMX
@@ -94,6 +104,10 @@ namespace Stockfish::Eval::NNUE {
   #define vec_add_psqt_32(a,b) _mm_add_pi32(a,b)
   #define vec_sub_psqt_32(a,b) _mm_sub_pi32(a,b)
   #define vec_zero_psqt() _mm_setzero_si64()
+  #define vec_set_16(a) _mm_set1_pi16(a)
+  #define vec_mul_16(a,b) _mm_mullo_pi16(a,b)
+  #define vec_load_8_16(a) _mm_srai_pi16(_mm_unpacklo_pi8(_mm_setzero_si64(), \
+                               _mm_cvtsi32_si64(*reinterpret_cast<const int*>(a))), 8)
   #define NumRegistersSIMD 8
 
   #elif USE_NEON
@@ -108,6 +122,9 @@ namespace Stockfish::Eval::NNUE {
   #define vec_add_psqt_32(a,b) vaddq_s32(a,b)
   #define vec_sub_psqt_32(a,b) vsubq_s32(a,b)
   #define vec_zero_psqt() psqt_vec_t{0}
+  #define vec_set_16(a) vdupq_n_s16(a)
+  #define vec_mul_16(a,b) vmulq_s16(a,b)
+  #define vec_load_8_16(a) vmovl_s8(vld1_s8(a))
   #define NumRegistersSIMD 16
 
   #else
@@ -154,7 +171,6 @@ namespace Stockfish::Eval::NNUE {
           return 1;
       }
 
-      static constexpr int NumRegs     = BestRegisterCount<vec_t, WeightType, TransformedFeatureDimensions, NumRegistersSIMD>();
       static constexpr int NumPsqtRegs = BestRegisterCount<psqt_vec_t, PSQTWeightType, PSQTBuckets, NumRegistersSIMD>();
 
       #pragma GCC diagnostic pop
@@ -163,14 +179,27 @@ namespace Stockfish::Eval::NNUE {
 
 
 
-  // Input feature converter
+  // Input feature converter. The weights are either stored as 16-bit values,
+  // or quantized to 8 bits with a 16-bit scale per feature, which halves the
+  // size of the net and the memory traffic of the accumulator updates.
+  template <IndexType TransformedFeatureDims, typename TransformerWeightType = WeightType>
   class FeatureTransformer {
 
    private:
     // Number of output dimensions for one side
-    static constexpr IndexType HalfDimensions = TransformedFeatureDimensions;
+    static constexpr IndexType HalfDimensions = TransformedFeatureDims;
+    static_assert(HalfDimensions <= TransformedFeatureDimensions, "The accumulator is too small");
+
+    // Whether the weights are quantized to 8 bits
+    static constexpr bool Quantized = std::is_same_v<TransformerWeightType, std::int8_t>;
+    static_assert(Quantized || std::is_same_v<TransformerWeightType, WeightType>);
 
     #ifdef VECTOR
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wignored-attributes"
+    static constexpr int NumRegs = BestRegisterCount<vec_t, WeightType, HalfDimensions, NumRegistersSIMD>();
+    #pragma GCC diagnostic pop
+
     static constexpr IndexType TileHeight = NumRegs * sizeof(vec_t) / 2;
     static constexpr IndexType PsqtTileHeight = NumPsqtRegs * sizeof(psqt_vec_t) / 4;
     static_assert(HalfDimensions % TileHeight == 0, "TileHeight must divide HalfDimensions");
@@ -191,14 +220,16 @@ namespace Stockfish::Eval::NNUE {
 
     // Hash value embedded in the evaluation file
     static constexpr std::uint32_t get_hash_value() {
-      return FeatureSet::HashValue ^ OutputDimensions;
+      return FeatureSet::HashValue ^ OutputDimensions ^ (Quantized ? 0x80000000u : 0);
     }
 
     // Read network parameters
     bool read_parameters(std::istream& stream) {
 
       read_little_endian<BiasType      >(stream, biases     , HalfDimensions                  );
-      read_little_endian<WeightType    >(stream, weights    , HalfDimensions * FeatureSet::get_dimensions());
+      if constexpr (Quantized)
+          read_little_endian<BiasType  >(stream, weightScales, FeatureSet::get_dimensions()    );
+      read_little_endian<TransformerWeightType>(stream, weights, HalfDimensions * FeatureSet::get_dimensions());
       read_little_endian<PSQTWeightType>(stream, psqtWeights, PSQTBuckets    * FeatureSet::get_dimensions());
 
       return !stream.fail();
@@ -208,7 +239,9 @@ namespace Stockfish::Eval::NNUE {
     bool write_parameters(std::ostream& stream) const {
 
       write_little_endian<BiasType      >(stream, biases     , HalfDimensions                  );
-      write_little_endian<WeightType    >(stream, weights    , HalfDimensions * FeatureSet::get_dimensions());
+      if constexpr (Quantized)
+          write_little_endian<BiasType  >(stream, weightScales, FeatureSet::get_dimensions()    );
+      write_little_endian<TransformerWeightType>(stream, weights, HalfDimensions * FeatureSet::get_dimensions());
       write_little_endian<PSQTWeightType>(stream, psqtWeights, PSQTBuckets    * FeatureSet::get_dimensions());
 
       return !stream.fail();
@@ -364,6 +397,26 @@ namespace Stockfish::Eval::NNUE {
 
 
    private:
+  #ifdef VECTOR
+    // Register k of the weights of a feature from the given offset on,
+    // as 16-bit values
+    vec_t weight_vector(IndexType index, IndexType offset, IndexType k) const {
+      if constexpr (Quantized)
+        return vec_mul_16(vec_load_8_16(&weights[offset + k * (sizeof(vec_t) / 2)]),
+                          vec_set_16(weightScales[index]));
+      else
+        return reinterpret_cast<const vec_t*>(&weights[offset])[k];
+    }
+  #endif
+
+    // Weight of a feature at the given offset as a 16-bit value
+    WeightType weight(IndexType index, IndexType offset) const {
+      if constexpr (Quantized)
+        return WeightType(weights[offset] * weightScales[index]);
+      else
+        return weights[offset];
+    }
+
     void update_accumulator(const Position& pos, const Color perspective) const {
 
       // The size must be enough to contain the largest possible update.
@@ -399,6 +452,8 @@ namespace Stockfish::Eval::NNUE {
         if (next == nullptr)
           return;
 
+        pos.this_thread()->counters.inc(CNT_NNUE_INCREMENTAL);
+
         // Update incrementally in two steps. First, we update the "next"
         // accumulator. Then, we update the current accumulator (pos.state()).
 
@@ -433,18 +488,16 @@ namespace Stockfish::Eval::NNUE {
             for (const auto index : removed[i])
             {
               const IndexType offset = HalfDimensions * index + j * TileHeight;
-              auto column = reinterpret_cast<const vec_t*>(&weights[offset]);
               for (IndexType k = 0; k < NumRegs; ++k)
-                acc[k] = vec_sub_16(acc[k], column[k]);
+                acc[k] = vec_sub_16(acc[k], weight_vector(index, offset, k));
             }
 
             // Difference calculation for the activated features
             for (const auto index : added[i])
             {
               const IndexType offset = HalfDimensions * index + j * TileHeight;
-              auto column = reinterpret_cast<const vec_t*>(&weights[offset]);
               for (IndexType k = 0; k < NumRegs; ++k)
-                acc[k] = vec_add_16(acc[k], column[k]);
+                acc[k] = vec_add_16(acc[k], weight_vector(index, offset, k));
             }
 
             // Store accumulator
@@ -509,7 +562,7 @@ namespace Stockfish::Eval::NNUE {
             const IndexType offset = HalfDimensions * index;
 
             for (IndexType j = 0; j < HalfDimensions; ++j)
-              st->accumulator.accumulation[perspective][j] -= weights[offset + j];
+              st->accumulator.accumulation[perspective][j] -= weight(index, offset + j);
 
             for (std::size_t k = 0; k < PSQTBuckets; ++k)
               st->accumulator.psqtAccumulation[perspective][k] -= psqtWeights[index * PSQTBuckets + k];
@@ -521,7 +574,7 @@ namespace Stockfish::Eval::NNUE {
             const IndexType offset = HalfDimensions * index;
 
             for (IndexType j = 0; j < HalfDimensions; ++j)
-              st->accumulator.accumulation[perspective][j] += weights[offset + j];
+              st->accumulator.accumulation[perspective][j] += weight(index, offset + j);
 
             for (std::size_t k = 0; k < PSQTBuckets; ++k)
               st->accumulator.psqtAccumulation[perspective][k] += psqtWeights[index * PSQTBuckets + k];
@@ -532,6 +585,7 @@ namespace Stockfish::Eval::NNUE {
       else
       {
         // Refresh the accumulator
+        pos.this_thread()->counters.inc(CNT_NNUE_REFRESH);
         auto& accumulator = pos.state()->accumulator;
         accumulator.computed[perspective] = true;
         IndexList active;
@@ -548,10 +602,8 @@ namespace Stockfish::Eval::NNUE {
           for (const auto index : active)
           {
             const IndexType offset = HalfDimensions * index + j * TileHeight;
-            auto column = reinterpret_cast<const vec_t*>(&weights[offset]);
-
             for (unsigned k = 0; k < NumRegs; ++k)
-              acc[k] = vec_add_16(acc[k], column[k]);
+              acc[k] = vec_add_16(acc[k], weight_vector(index, offset, k));
           }
 
           auto accTile = reinterpret_cast<vec_t*>(
@@ -592,7 +644,7 @@ namespace Stockfish::Eval::NNUE {
           const IndexType offset = HalfDimensions * index;
 
           for (IndexType j = 0; j < HalfDimensions; ++j)
-            accumulator.accumulation[perspective][j] += weights[offset + j];
+            accumulator.accumulation[perspective][j] += weight(index, offset + j);
 
           for (std::size_t k = 0; k < PSQTBuckets; ++k)
             accumulator.psqtAccumulation[perspective][k] += psqtWeights[index * PSQTBuckets + k];
@@ -606,7 +658,8 @@ namespace Stockfish::Eval::NNUE {
     }
 
     alignas(CacheLineSize) BiasType biases[HalfDimensions];
-    alignas(CacheLineSize) WeightType weights[HalfDimensions * InputDimensions];
+    alignas(CacheLineSize) BiasType weightScales[Quantized ? InputDimensions : 1];
+    alignas(CacheLineSize) TransformerWeightType weights[HalfDimensions * InputDimensions];
     alignas(CacheLineSize) PSQTWeightType psqtWeights[InputDimensions * PSQTBuckets];
   };
 
@@ -101,11 +101,11 @@ std::ostream& operator<<(std::ostream& os, const Position& pos) {
       os << UCI::square(pos, pop_lsb(b)) << " ";
 
   os << "\nChased: ";
-  for (Bitboard b = pos.state()->chased; b; )
+  for (Bitboard b = pos.chased_pieces(); b; )
       os << UCI::square(pos, pop_lsb(b)) << " ";
 
   if (    int(Tablebases::MaxCardinality) >= popcount(pos.pieces())
-      && Options["UCI_Variant"] == "chess"
+      && Search::Settings.chessVariant
       && !pos.can_castle(ANY_CASTLING))
   {
       StateInfo st;
@@ -269,6 +269,7 @@ Position& Position::set(const Variant* v, const string& fenStr, bool isChess960,
   st = si;
 
   var = v;
+  pieceSquare = PSQT::table(v)->psq;
 
   ss >> std::noskipws;
 
@@ -573,7 +574,7 @@ Position& Position::set(const Variant* v, const string& fenStr, bool isChess960,
   }
 
   chess960 = isChess960 || v->chess960;
-  tsumeMode = Options["TsumeMode"];
+  tsumeMode = Search::Settings.tsumeMode;
   thisThread = th;
   updatePawnCheckZone();
   set_state(st);
@@ -628,8 +629,10 @@ void Position::set_check_info(StateInfo* si) const {
   }
   si->shak = si->checkersBB & (byTypeBB[KNIGHT] | byTypeBB[ROOK] | byTypeBB[BERS]);
   si->bikjang = var->bikjangRule && ksq != SQ_NONE ? bool(attacks_bb(sideToMove, ROOK, ksq, pieces()) & pieces(sideToMove, KING)) : false;
-  si->chased = var->chasingRule ? chased() : Bitboard(0);
+  si->chased = 0;
+  si->chasedComputed = !var->chasingRule;
   si->legalCapture = NO_VALUE;
+  si->pseudoRoyalCheck = NO_VALUE;
   if (var->extinctionPseudoRoyal)
   {
       si->pseudoRoyalCandidates = 0;
@@ -1120,6 +1123,35 @@ bool Position::legal(Move m) const {
   assert(!count<KING>(us) || piece_on(square<KING>(us)) == make_piece(us, KING));
   assert(board_bb() & to);
 
+  // Fast path for variants without special legality rules (see Variant::conclude()).
+  // When not in check, only moving a blocker can expose the king to a slider.
+  // Unchecked pseudo-royal pieces are only exposed by quiet moves off their lines.
+  if (var->fastLegality && !checkers() && type_of(moved_piece(m)) != KING)
+  {
+      if (immobility_illegal() && (type_of(m) == DROP || type_of(m) == NORMAL) && !(PseudoMoves[0][us][type_of(moved_piece(m))][to] & board_bb()))
+          return false;
+
+      bool pseudoRoyalSafe = true;
+      if (var->extinctionPseudoRoyal)
+      {
+          if (st->pseudoRoyalCheck == NO_VALUE)
+              st->pseudoRoyalCheck = checked_pseudo_royals(us) ? VALUE_TRUE : VALUE_FALSE;
+          pseudoRoyalSafe =   st->pseudoRoyalCheck == VALUE_FALSE
+                           && (type_of(m) == DROP || (type_of(m) == NORMAL && !capture(m) && !(st->pseudoRoyals & from)))
+                           && !walling();
+          for (Bitboard b = st->pseudoRoyals & pieces(us); pseudoRoyalSafe && b && type_of(m) != DROP; )
+              pseudoRoyalSafe = !(PseudoAttacks[us][QUEEN][pop_lsb(b)] & from);
+      }
+
+      if (pseudoRoyalSafe)
+      {
+          if (type_of(m) == DROP)
+              return true;
+          if ((type_of(m) == NORMAL || type_of(m) == PROMOTION) && !(blockers_for_king(us) & from))
+              return true;
+      }
+  }
+
   // Illegal checks
   if ((!checking_permitted() || (sittuyin_promotion() && type_of(m) == PROMOTION) || (!drop_checks() && type_of(m) == DROP)) && gives_check(m))
       return false;
@@ -1623,6 +1655,14 @@ void Position::do_move(Move m, StateInfo& newSt, bool givesCheck) {
 #endif
   Key k = st->key ^ Zobrist::side;
 
+  // Chase sets are computed for repetitions by taking back plain moves on the
+  // board, see update_chased(). Other moves which do not end the repetition
+  // window need the chase sets of the window now, while its boards can be rebuilt.
+  if (   var->chasingRule
+      && (type_of(m) != NORMAL || is_gating(m) || capture(m))
+      && (!capture(m) || captures_to_hand()))
+      update_chased();
+
   // Copy some fields of the old state to our new StateInfo object except the
   // ones which are going to be recalculated from scratch anyway and then switch
   // our state pointer to point to the new (ready to be updated) state.
@@ -2213,6 +2253,14 @@ void Position::do_move(Move m, StateInfo& newSt, bool givesCheck) {
   updatePawnCheckZone();
   // Update the key with the final value
   st->key = k;
+#ifndef NO_THREADS
+  // Prefetch the evaluation hash entries of the new position. The material
+  // entry was already prefetched if the move is a capture.
+  if (st->pawnKey != st->previous->pawnKey)
+      prefetch(thisThread->pawnsTable[st->pawnKey]);
+  if (!captured && st->materialKey != st->previous->materialKey)
+      prefetch(thisThread->materialTable[material_key(var->endgameEval)]);
+#endif
   // Calculate checkers bitboard (if move gives check)
   st->checkersBB = givesCheck ? attackers_to(square<KING>(them), us) & pieces(us) : Bitboard(0);
   assert(givesCheck == bool(st->checkersBB) || (givesCheck && var->prisonPawnPromotion));
@@ -2240,9 +2288,15 @@ void Position::do_move(Move m, StateInfo& newSt, bool givesCheck) {
   // Calculate the repetition info. It is the ply distance from the previous
   // occurrence of the same position, negative in the 3-fold case, or zero
   // if the position was not repeated.
+  // Search threads look it up in their repetition index instead of walking.
   st->repetition = 0;
   int end = captures_to_hand() ? st->pliesFromNull : std::min(st->rule50, st->pliesFromNull);
-  if (end >= 4)
+  if (repetitionIndex)
+  {
+      st->repetition = repetitionIndex->repetition(st->key, end);
+      repetitionIndex->push(st->key, st->repetition);
+  }
+  else if (end >= 4)
   {
       StateInfo* stp = st->previous->previous;
       for (int i = 4; i <= end; i += 2)
@@ -2256,6 +2310,10 @@ void Position::do_move(Move m, StateInfo& newSt, bool givesCheck) {
       }
   }
 
+  // Chase sets are only needed if the position repeats
+  if (var->chasingRule && st->repetition)
+      update_chased(end);
+
   assert(pos_is_ok());
 }
 
@@ -2421,6 +2479,8 @@ void Position::undo_move(Move m) {
   }
 
   // Finally point our state pointer back to the previous state
+  if (repetitionIndex)
+      repetitionIndex->pop();
   st = st->previous;
   --gamePly;
 
@@ -2504,6 +2564,8 @@ void Position::do_null_move(StateInfo& newSt) {
   set_check_info(st);
 
   st->repetition = 0;
+  if (repetitionIndex)
+      repetitionIndex->push(st->key, 0);
 
   assert(pos_is_ok());
 }
@@ -2515,6 +2577,8 @@ void Position::undo_null_move() {
 
   assert(!checkers());
 
+  if (repetitionIndex)
+      repetitionIndex->pop();
   st = st->previous;
   sideToMove = ~sideToMove;
 }
@@ -2766,13 +2830,51 @@ bool Position::see_ge(Move m, Value threshold) const {
   return bool(res);
 }
 
+/// Position::has_any_legal_move() tests whether the side to move has a legal move.
+/// It gives the same answer as MoveList<LEGAL>(pos).size() but generates the moves
+/// by category, captures, moves on the board and drops, and stops at the first
+/// legal one. Evasions are few and generated at once.
+
+bool Position::has_any_legal_move() const {
+
+  if (is_immediate_game_end())
+      return false;
+
+  if (checkers())
+  {
+      for (const auto& mevasion : MoveList<EVASIONS>(*this))
+          if (legal(mevasion) && !virtual_drop(mevasion))
+              return true;
+      return false;
+  }
+
+  // Captures are generated and cached anyway by legality checks of quiet moves
+  if (must_capture() && has_capture())
+      return true;
+
+  for (const auto& m : MoveList<CAPTURES>(*this))
+      if (legal(m))
+          return true;
+
+  for (const auto& m : MoveList<BOARD_QUIETS>(*this))
+      if (legal(m))
+          return true;
+
+  for (const auto& m : MoveList<DROPS>(*this))
+      if (legal(m) && !virtual_drop(m))
+          return true;
+
+  return false;
+}
+
+
 /// Position::is_optional_game_end() tests whether the position may end the game by
 /// 50-move rule, by repetition, or a variant rule that allows a player to claim a game result.
 
 bool Position::is_optional_game_end(Value& result, int ply, int countStarted) const {
 
   // n-move rule
-  if (n_move_rule() && st->rule50 > (2 * n_move_rule() - 1) && (!checkers() || MoveList<LEGAL>(*this).size()))
+  if (n_move_rule() && st->rule50 > (2 * n_move_rule() - 1) && (!checkers() || has_any_legal_move()))
   {
       int offset = 0;
       if (var->chasingRule == AXF_CHASING && st->pliesFromNull >= 20)
@@ -2801,12 +2903,15 @@ bool Position::is_optional_game_end(Value& result, int ply, int countStarted) co
   {
       int end = captures_to_hand() ? st->pliesFromNull : std::min(st->rule50, st->pliesFromNull);
 
-      if (end >= 4)
+      // Without a repetition in the window only the Janggi move repetition rule can apply
+      if (end >= 4 && (st->repetition || (var->moveRepetitionIllegal && type_of(st->move) == NORMAL)))
       {
           StateInfo* stp = st->previous->previous;
           int cnt = 0;
           bool perpetualThem = var->perpetualCheckIllegal && st->checkersBB && stp->checkersBB;
           bool perpetualUs = var->perpetualCheckIllegal && st->previous->checkersBB && stp->previous->checkersBB;
+
+
           Bitboard chaseThem = undo_move_board(st->chased, st->previous->move) & stp->chased;
           Bitboard chaseUs = undo_move_board(st->previous->chased, stp->move) & stp->previous->chased;
           int moveRepetition = var->moveRepetitionIllegal
@@ -2874,7 +2979,7 @@ bool Position::is_optional_game_end(Value& result, int ply, int countStarted) co
   if (   counting_rule()
       && st->countingLimit
       && counting_ply(countStarted) > counting_limit(countStarted)
-      && (!checkers() || MoveList<LEGAL>(*this).size()))
+      && (!checkers() || has_any_legal_move()))
   {
       result = VALUE_DRAW;
       return true;
@@ -3142,9 +3247,58 @@ bool Position::is_immediate_game_end(Value& result, int ply) const {
   return false;
 }
 
+// Position::update_chased() computes the missing chase sets of the current
+// state and of the given number of states before it. The boards of earlier
+// states are rebuilt by taking back plain moves, and restored afterwards. The
+// states before any other move got their chase sets in do_move(). A computed
+// chase set implies that the ones before it in its window are computed too,
+// so the search stops at its root and never writes to the shared setup states.
+
+void Position::update_chased(int plies) {
+
+  if (st->chasedComputed)
+      return;
+
+  st->chased = chased();
+  st->chasedComputed = true;
+
+  Move m = st->move;
+  if (plies <= 0 || !is_ok(m) || type_of(m) != NORMAL || is_gating(m) || st->capturedPiece)
+      return;
+
+  StateInfo* current = st;
+  Color us = sideToMove;
+  Square from = from_sq(m), to = to_sq(m);
+  Piece pc = board[to];
+  Bitboard fromTo = square_bb(from) ^ to;
+
+  // Take back the move on the board only
+  byTypeBB[ALL_PIECES] ^= fromTo;
+  byTypeBB[type_of(pc)] ^= fromTo;
+  byColorBB[color_of(pc)] ^= fromTo;
+  board[to] = NO_PIECE;
+  board[from] = pc;
+  sideToMove = color_of(pc);
+  st = st->previous;
+
+  update_chased(plies - 1);
+
+  st = current;
+  sideToMove = us;
+  byTypeBB[ALL_PIECES] ^= fromTo;
+  byTypeBB[type_of(pc)] ^= fromTo;
+  byColorBB[color_of(pc)] ^= fromTo;
+  board[from] = NO_PIECE;
+  board[to] = pc;
+}
+
+
 // Position::chased() tests whether the last move was a chase.
 
 Bitboard Position::chased() const {
+  if (UseCounters && thisThread)
+      thisThread->counters.inc(CNT_CHASED);
+
   Bitboard b = 0;
   if (st->move == MOVE_NONE)
       return b;
@@ -3281,6 +3435,32 @@ bool Position::has_repeated() const {
 }
 
 
+/// Position::init_repetition_index() attaches a repetition index and fills it
+/// with the states of the current chain that a repetition can still reach. It
+/// must be called after the chain is relinked. Without an index, or when the
+/// history does not fit, do_move() walks the chain instead.
+
+void Position::init_repetition_index(RepetitionIndex* ri) {
+
+  repetitionIndex = nullptr;
+  ri->clear();
+
+  int end = captures_to_hand() ? st->pliesFromNull : std::min(st->rule50, st->pliesFromNull);
+  if (end >= RepetitionIndex::MaxHistory)
+      return;
+
+  // Push the oldest state first, so that positions in the index follow the line
+  StateInfo* window[RepetitionIndex::MaxHistory];
+  int n = 0;
+  for (StateInfo* stp = st; stp && n <= end; stp = stp->previous)
+      window[n++] = stp;
+  while (n--)
+      ri->push(window[n]->key, window[n]->repetition);
+
+  repetitionIndex = ri;
+}
+
+
 /// Position::has_game_cycle() tests if the position has a move which draws by repetition,
 /// or an earlier position has a move that directly reaches the current position.
 
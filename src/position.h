@@ -77,10 +77,12 @@ struct StateInfo {
   Bitboard   pseudoRoyalCandidates;
   Bitboard   pseudoRoyals;
   OptBool    legalCapture;
+  OptBool    pseudoRoyalCheck;
   bool       capturedpromoted;
   bool       shak;
   bool       bikjang;
   Bitboard   chased;
+  bool       chasedComputed;
   bool       pass;
   Move       move;
   int        repetition;
@@ -101,6 +103,65 @@ struct StateInfo {
 typedef std::unique_ptr<std::deque<StateInfo>> StateListPtr;
 
 
+/// RepetitionIndex maps the keys of the states in a line to their positions in
+/// the line, so that do_move() finds the previous occurrence of a position in
+/// expected constant time instead of walking back the StateInfo chain, which
+/// is long in drop variants where the 50-move counter never resets. Each
+/// search thread owns one. Entries are pushed and popped in last-in first-out
+/// order, so a popped slot of the open-addressed table can just be emptied.
+
+class RepetitionIndex {
+
+  static constexpr int Size = 4096;
+
+  struct Entry {
+    Key key;
+    int pos; // Position in the line plus one, zero if the slot is empty
+    int repetition;
+  };
+
+  Entry table[Size] = {};
+  uint16_t slots[Size];
+  int count = 0;
+
+public:
+  // The longest history that leaves room for the search line
+  static constexpr int MaxHistory = Size / 2 - 2 * MAX_PLY;
+
+  void clear() {
+    while (count)
+        table[slots[--count]].pos = 0;
+  }
+
+  // The repetition info of a new state, like the walk in Position::do_move()
+  int repetition(Key key, int end) const {
+    int dist = 0, rep = 0;
+    for (int i = key & (Size - 1); table[i].pos; i = (i + 1) & (Size - 1))
+        if (table[i].key == key)
+        {
+            int d = count + 1 - table[i].pos;
+            if (d >= 4 && d <= end && !(d & 1) && (!dist || d < dist))
+                dist = d, rep = table[i].repetition;
+        }
+    return rep ? -dist : dist;
+  }
+
+  void push(Key key, int repetition) {
+    assert(count < Size / 2);
+    int i = key & (Size - 1);
+    while (table[i].pos)
+        i = (i + 1) & (Size - 1);
+    table[i] = { key, ++count, repetition };
+    slots[count - 1] = uint16_t(i);
+  }
+
+  void pop() {
+    assert(count > 0);
+    table[slots[--count]].pos = 0;
+  }
+};
+
+
 /// Position class stores information regarding the board representation as
 /// pieces, side to move, hash keys, castling info, etc. Important methods are
 /// do_move() and undo_move(), used by the search to update node info when
@@ -172,6 +233,7 @@ public:
   bool drop_checks() const;
   bool must_capture() const;
   bool has_capture() const;
+  bool has_any_legal_move() const;
   bool must_drop() const;
   bool piece_drops() const;
   bool drop_loop() const;
@@ -336,7 +398,10 @@ public:
   bool is_draw(int ply) const;
   bool has_game_cycle(int ply) const;
   bool has_repeated() const;
+  void init_repetition_index(RepetitionIndex* ri);
   Bitboard chased() const;
+  Bitboard chased_pieces() const;
+  void update_chased();
   int count_limit(Color sideToCount) const;
   int board_honor_counting_ply(int countStarted) const;
   bool board_honor_counting_shorter(int countStarted) const;
@@ -367,6 +432,7 @@ private:
 
   // Other helpers
   void move_piece(Square from, Square to);
+  void update_chased(int plies);
   template<bool Do>
   void do_castling(Color us, Square from, Square& to, Square& rfrom, Square& rto);
 
@@ -387,6 +453,7 @@ private:
 
   // variant-specific
   const Variant* var;
+  const Score (*pieceSquare)[SQUARE_NB + 1];
   bool tsumeMode;
   bool chess960;
   int pieceCountInHand[COLOR_NB][PIECE_TYPE_NB];
@@ -396,6 +463,7 @@ private:
   int priorityDropCountInHand[COLOR_NB];
   int virtualPieces;
   Bitboard promotedPieces;
+  RepetitionIndex* repetitionIndex; // Owned by the search thread, or null
   void add_to_hand(Piece pc);
   void remove_from_hand(Piece pc);
   int add_to_prison(Piece pc);
@@ -747,6 +815,15 @@ inline bool Position::has_capture() const {
   return false;
 }
 
+inline Bitboard Position::chased_pieces() const {
+  // Chase sets are only stored for repetitions, see update_chased()
+  return st->chasedComputed ? st->chased : chased();
+}
+
+inline void Position::update_chased() {
+  update_chased(captures_to_hand() ? st->pliesFromNull : std::min(st->rule50, st->pliesFromNull));
+}
+
 inline bool Position::must_drop() const {
   assert(var != nullptr);
   return var->mustDrop;
@@ -1636,7 +1713,7 @@ inline void Position::put_piece(Piece pc, Square s, bool isPromoted, Piece unpro
   byColorBB[color_of(pc)] |= s;
   pieceCount[pc]++;
   pieceCount[make_piece(color_of(pc), ALL_PIECES)]++;
-  psq += PSQT::psq[pc][s];
+  psq += pieceSquare[pc][s];
   if (isPromoted)
       promotedPieces |= s;
   unpromotedBoard[s] = unpromotedPc;
@@ -1654,7 +1731,7 @@ inline void Position::remove_piece(Square s) {
   board[s] = NO_PIECE;
   pieceCount[pc]--;
   pieceCount[make_piece(color_of(pc), ALL_PIECES)]--;
-  psq -= PSQT::psq[pc][s];
+  psq -= pieceSquare[pc][s];
   promotedPieces -= s;
   unpromotedBoard[s] = NO_PIECE;
 
@@ -1672,7 +1749,7 @@ inline void Position::move_piece(Square from, Square to) {
   byColorBB[color_of(pc)] ^= fromTo;
   board[from] = NO_PIECE;
   board[to] = pc;
-  psq += PSQT::psq[pc][to] - PSQT::psq[pc][from];
+  psq += pieceSquare[pc][to] - pieceSquare[pc][from];
   if (is_promoted(from))
       promotedPieces ^= fromTo;
   unpromotedBoard[to] = unpromotedBoard[from];
@@ -1767,7 +1844,7 @@ inline void Position::add_to_hand(Piece pc) {
   pieceCountInHand[color_of(pc)][type_of(pc)]++;
   pieceCountInHand[color_of(pc)][ALL_PIECES]++;
   priorityDropCountInHand[color_of(pc)] += var->isPriorityDrop[type_of(pc)];
-  psq += PSQT::psq[pc][SQ_NONE];
+  psq += pieceSquare[pc][SQ_NONE];
 }
 
 inline void Position::remove_from_hand(Piece pc) {
@@ -1775,7 +1852,7 @@ inline void Position::remove_from_hand(Piece pc) {
   pieceCountInHand[color_of(pc)][type_of(pc)]--;
   pieceCountInHand[color_of(pc)][ALL_PIECES]--;
   priorityDropCountInHand[color_of(pc)] -= var->isPriorityDrop[type_of(pc)];
-  psq -= PSQT::psq[pc][SQ_NONE];
+  psq -= pieceSquare[pc][SQ_NONE];
 }
 
 inline int Position::add_to_prison(Piece pc) {
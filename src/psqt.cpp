@@ -20,6 +20,7 @@
 #include "psqt.h"
 
 #include <algorithm>
+#include <mutex>
 #include <sstream>
 #include <math.h>
 
@@ -186,12 +187,15 @@ Value piece_value(Phase phase, PieceType pt)
 namespace PSQT
 {
 
-Score psq[PIECE_NB][SQUARE_NB + 1];
+namespace {
 
-// PSQT::init() initializes piece-square tables: the white halves of the tables are
-// copied from Bonus[] and PBonus[], adding the piece value, then the black halves of
-// the tables are initialized by flipping and changing the sign of the white scores.
-void init(const Variant* v) {
+// compute() initializes the piece-square tables of a variant: the white halves of
+// the tables are copied from Bonus[] and PBonus[], adding the piece value, then the
+// black halves of the tables are initialized by flipping and changing the sign of
+// the white scores.
+void compute(const Variant* v, Table& t) {
+
+  std::copy(&PieceValue[0][0], &PieceValue[0][0] + PHASE_NB * PIECE_NB, &t.pieceValue[0][0]);
 
   PieceType strongestPiece = NO_PIECE_TYPE;
   for (PieceSet ps = v->pieceTypes; ps;)
@@ -199,23 +203,23 @@ void init(const Variant* v) {
       PieceType pt = pop_lsb(ps);
       if (is_custom(pt))
       {
-          PieceValue[MG][pt] = piece_value(MG, pt);
-          PieceValue[EG][pt] = piece_value(EG, pt);
+          t.pieceValue[MG][pt] = piece_value(MG, pt);
+          t.pieceValue[EG][pt] = piece_value(EG, pt);
       }
 
-      if (PieceValue[MG][pt] > PieceValue[MG][strongestPiece])
+      if (t.pieceValue[MG][pt] > t.pieceValue[MG][strongestPiece])
           strongestPiece = pt;
   }
 
   Value maxPromotion = VALUE_ZERO;
   for (PieceSet ps = v->promotionPieceTypes[WHITE]; ps;)
-      maxPromotion = std::max(maxPromotion, PieceValue[EG][pop_lsb(ps)]);
+      maxPromotion = std::max(maxPromotion, t.pieceValue[EG][pop_lsb(ps)]);
 
   for (PieceType pt = PAWN; pt <= KING; ++pt)
   {
       Piece pc = make_piece(WHITE, pt);
 
-      Score score = make_score(PieceValue[MG][pc], PieceValue[EG][pc]);
+      Score score = make_score(t.pieceValue[MG][pc], t.pieceValue[EG][pc]);
 
       // Consider promotion types in pawn score
       if (pt == v->promotionPawnType[WHITE])
@@ -274,13 +278,13 @@ void init(const Variant* v) {
       if (   v->extinctionValue == -VALUE_MATE
           && v->extinctionPieceCount == 0
           && (v->extinctionPieceTypes & ALL_PIECES))
-          score += make_score(0, std::max(KnightValueEg - PieceValue[EG][pt], VALUE_ZERO) / 20);
+          score += make_score(0, std::max(KnightValueEg - t.pieceValue[EG][pt], VALUE_ZERO) / 20);
 
       // The strongest piece of a variant usually has some dominance, such as rooks in Makruk and Xiangqi.
       // This does not apply to drop variants.
       if (pt == strongestPiece && v->captureType == MOVE_OUT)
-              score += make_score(std::max(QueenValueMg - PieceValue[MG][pt], VALUE_ZERO) / 20,
-                                  std::max(QueenValueEg - PieceValue[EG][pt], VALUE_ZERO) / 20);
+              score += make_score(std::max(QueenValueMg - t.pieceValue[MG][pt], VALUE_ZERO) / 20,
+                                  std::max(QueenValueEg - t.pieceValue[EG][pt], VALUE_ZERO) / 20);
 
       // For antichess variants, use negative piece values
       if (v->extinctionValue == VALUE_MATE)
@@ -292,15 +296,15 @@ void init(const Variant* v) {
       if (v->pieceValue[EG][pt])
           score = make_score(mg_value(score), v->pieceValue[EG][pt]);
 
-      CapturePieceValue[MG][pc] = CapturePieceValue[MG][~pc] = mg_value(score);
-      CapturePieceValue[EG][pc] = CapturePieceValue[EG][~pc] = eg_value(score);
+      t.capturePieceValue[MG][pc] = t.capturePieceValue[MG][~pc] = mg_value(score);
+      t.capturePieceValue[EG][pc] = t.capturePieceValue[EG][~pc] = eg_value(score);
 
       // For drop variants, halve the piece values to compensate for double changes by captures
       if (v->captureType != MOVE_OUT)
           score = score / 2;
 
-      EvalPieceValue[MG][pc] = EvalPieceValue[MG][~pc] = mg_value(score);
-      EvalPieceValue[EG][pc] = EvalPieceValue[EG][~pc] = eg_value(score);
+      t.evalPieceValue[MG][pc] = t.evalPieceValue[MG][~pc] = mg_value(score);
+      t.evalPieceValue[EG][pc] = t.evalPieceValue[EG][~pc] = eg_value(score);
 
       // Determine pawn rank
       std::istringstream ss(v->startFen);
@@ -319,35 +323,73 @@ void init(const Variant* v) {
       {
           File f = std::max(File(edge_distance(file_of(s), v->maxFile)), FILE_A);
           Rank r = rank_of(s);
-          psq[ pc][s] = score + (  pt == PAWN  ? PBonus[std::min(r, RANK_8)][std::min(file_of(s), FILE_H)]
-                                 : pt == KING  ? KingBonus[std::clamp(Rank(r - pawnRank + 1), RANK_1, RANK_8)][std::min(f, FILE_D)] * (1 + (v->captureType != MOVE_OUT))
-                                 : pt <= QUEEN ? Bonus[pc][std::min(r, RANK_8)][std::min(f, FILE_D)] * (1 + v->blastOnCapture)
-                                 : pt == HORSE ? Bonus[KNIGHT][std::min(r, RANK_8)][std::min(f, FILE_D)]
-                                 : pt == COMMONER && v->extinctionValue == -VALUE_MATE && (v->extinctionPieceTypes & COMMONER) ? KingBonus[std::clamp(Rank(r - pawnRank + 1), RANK_1, RANK_8)][std::min(f, FILE_D)]
-                                 : isSlider    ? make_score(5, 5) * (2 * f + std::max(std::min(r, Rank(v->maxRank - r)), RANK_1) - v->maxFile - 1)
-                                 : isPawn      ? make_score(5, 5) * (2 * f - v->maxFile)
-                                               : make_score(10, 10) * (1 + isSlowLeaper) * (f + std::max(std::min(r, Rank(v->maxRank - r)), RANK_1) - v->maxFile / 2));
+          t.psq[ pc][s] = score + (  pt == PAWN  ? PBonus[std::min(r, RANK_8)][std::min(file_of(s), FILE_H)]
+                                   : pt == KING  ? KingBonus[std::clamp(Rank(r - pawnRank + 1), RANK_1, RANK_8)][std::min(f, FILE_D)] * (1 + (v->captureType != MOVE_OUT))
+                                   : pt <= QUEEN ? Bonus[pc][std::min(r, RANK_8)][std::min(f, FILE_D)] * (1 + v->blastOnCapture)
+                                   : pt == HORSE ? Bonus[KNIGHT][std::min(r, RANK_8)][std::min(f, FILE_D)]
+                                   : pt == COMMONER && v->extinctionValue == -VALUE_MATE && (v->extinctionPieceTypes & COMMONER) ? KingBonus[std::clamp(Rank(r - pawnRank + 1), RANK_1, RANK_8)][std::min(f, FILE_D)]
+                                   : isSlider    ? make_score(5, 5) * (2 * f + std::max(std::min(r, Rank(v->maxRank - r)), RANK_1) - v->maxFile - 1)
+                                   : isPawn      ? make_score(5, 5) * (2 * f - v->maxFile)
+                                                 : make_score(10, 10) * (1 + isSlowLeaper) * (f + std::max(std::min(r, Rank(v->maxRank - r)), RANK_1) - v->maxFile / 2));
           // Add a penalty for unpromoted soldiers
           if (pt == SOLDIER && r < v->soldierPromotionRank)
-              psq[pc][s] -= score * (v->soldierPromotionRank - r) / (4 + f);
+              t.psq[pc][s] -= score * (v->soldierPromotionRank - r) / (4 + f);
           // Corners are valuable in reversi
           if (v->enclosingDrop == REVERSI)
           {
               if (f == FILE_A && (r == RANK_1 || r == v->maxRank))
-                  psq[pc][s] += make_score(1000, 1000);
+                  t.psq[pc][s] += make_score(1000, 1000);
           }
           // In atomic variants pieces are "self-defending" and should therefore be pushed forward
           if (v->blastOnCapture)
-              psq[pc][s] += make_score(40, 0) * (r - v->maxRank / 2);
+              t.psq[pc][s] += make_score(40, 0) * (r - v->maxRank / 2);
           // Safe king squares
           if (r == RANK_1 && f <= FILE_B && ((pt == KING && v->checkCounting) || (pt == COMMONER && v->blastOnCapture)))
-              psq[pc][s] += make_score(100, 0);
-          psq[~pc][rank_of(s) <= v->maxRank ? flip_rank(s, v->maxRank) : s] = -psq[pc][s];
+              t.psq[pc][s] += make_score(100, 0);
+          t.psq[~pc][rank_of(s) <= v->maxRank ? flip_rank(s, v->maxRank) : s] = -t.psq[pc][s];
       }
       // Pieces in hand
-      psq[ pc][SQ_NONE] = score + make_score(35, 10) * (1 + !isSlider);
-      psq[~pc][SQ_NONE] = -psq[pc][SQ_NONE];
+      t.psq[ pc][SQ_NONE] = score + make_score(35, 10) * (1 + !isSlider);
+      t.psq[~pc][SQ_NONE] = -t.psq[pc][SQ_NONE];
+  }
+}
+
+} // namespace
+
+/// PSQT::table() returns the piece-square tables of a variant. They are computed
+/// at first use, which requires the piece map to be initialized for the variant.
+const Table* table(const Variant* v) {
+
+  static std::mutex mutex;
+  std::scoped_lock<std::mutex> lk(mutex);
+
+  if (!v->psqTable)
+  {
+      auto t = std::make_shared<Table>();
+      compute(v, *t);
+      v->psqTable = t;
+  }
+
+  return v->psqTable.get();
+}
+
+/// PSQT::init() sets the global piece values to the ones of the variant
+void init(const Variant* v) {
+
+  const Table* t = table(v);
+
+  for (PieceSet ps = v->pieceTypes; ps;)
+  {
+      PieceType pt = pop_lsb(ps);
+      if (is_custom(pt))
+      {
+          PieceValue[MG][pt] = t->pieceValue[MG][pt];
+          PieceValue[EG][pt] = t->pieceValue[EG][pt];
+      }
   }
+
+  std::copy(&t->evalPieceValue[0][0], &t->evalPieceValue[0][0] + PHASE_NB * PIECE_NB, &EvalPieceValue[0][0]);
+  std::copy(&t->capturePieceValue[0][0], &t->capturePieceValue[0][0] + PHASE_NB * PIECE_NB, &CapturePieceValue[0][0]);
 }
 
 } // namespace PSQT
@@ -28,9 +28,19 @@
 namespace Stockfish::PSQT
 {
 
-extern Score psq[PIECE_NB][SQUARE_NB + 1];
-
-// Fill psqt array from a set of internally linked parameters
+// Table holds the piece-square scores and piece values of a variant. It is
+// computed once per variant and shared by all of its positions.
+struct Table {
+  Score psq[PIECE_NB][SQUARE_NB + 1];
+  Value pieceValue[PHASE_NB][PIECE_NB];
+  Value evalPieceValue[PHASE_NB][PIECE_NB];
+  Value capturePieceValue[PHASE_NB][PIECE_NB];
+};
+
+// Return the table of a variant, computing it at first use
+const Table* table(const Variant* v);
+
+// Set the global piece values of the variant
 extern void init(const Variant*);
 
 } // namespace Stockfish::PSQT
@@ -309,7 +309,7 @@ extern "C" PyObject* pyffish_gameResult(PyObject* self, PyObject *args) {
 
     StateListPtr states(new std::deque<StateInfo>(1));
     buildPosition(pos, states, variant, fen, moveList, chess960);
-    assert(!MoveList<LEGAL>(pos).size());
+    assert(!pos.has_any_legal_move());
     gameEnd = pos.is_immediate_game_end(result);
     if (!gameEnd)
         result = pos.checkers() ? pos.checkmate_value() : pos.stalemate_value();
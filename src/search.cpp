@@ -42,12 +42,14 @@ namespace Stockfish {
 namespace Search {
 
   LimitsType Limits;
+  SettingsType Settings;
 }
 
 namespace Tablebases {
 
   int Cardinality;
   bool RootInTB;
+  bool UseFairy;
   bool UseRule50;
   Depth ProbeDepth;
 }
@@ -156,6 +158,19 @@ void Search::init() {
 
   for (int i = 1; i < MAX_MOVES; ++i)
       Reductions[i] = int(21.9 * std::log(i));
+
+  read_settings();
+}
+
+
+/// Search::read_settings() takes a snapshot of the options used during search
+
+void Search::read_settings() {
+
+  Settings.chessVariant = Options["UCI_Variant"] == "chess";
+  Settings.tsumeMode    = Options["TsumeMode"];
+  Settings.showWDL      = Options["UCI_ShowWDL"];
+  Settings.multiPV      = size_t(Options["MultiPV"]);
 }
 
 
@@ -188,6 +203,9 @@ void MainThread::search() {
   Time.init(rootPos, Limits, us, rootPos.game_ply());
   TT.new_search();
 
+  infoInterval = Options["Info Interval"];
+  lastOutputTime = 0;
+
   Eval::NNUE::verify();
 
   if (rootMoves.empty() || (CurrentProtocol == XBOARD && rootPos.is_optional_game_end()))
@@ -247,7 +265,7 @@ void MainThread::search() {
 
   bestThread = this;
 
-  if (   int(Options["MultiPV"]) == 1
+  if (   Settings.multiPV == 1
       && !Limits.depth
       && !(Skill(Options["Skill Level"]).enabled() || int(Options["UCI_LimitStrength"]))
       && rootMoves[0].pv[0] != MOVE_NONE)
@@ -354,7 +372,7 @@ void Thread::search() {
   std::copy(&lowPlyHistory[2][0], &lowPlyHistory.back().back() + 1, &lowPlyHistory[0][0]);
   std::fill(&lowPlyHistory[MAX_LPH - 2][0], &lowPlyHistory.back().back() + 1, 0);
 
-  size_t multiPV = size_t(Options["MultiPV"]);
+  size_t multiPV = Settings.multiPV;
 
   // Pick integer skill levels, but non-deterministically round up or down
   // such that the average integer skill corresponds to the input floating point one.
@@ -461,7 +479,8 @@ void Thread::search() {
               if (   mainThread
                   && multiPV == 1
                   && (bestValue <= alpha || bestValue >= beta)
-                  && Time.elapsed() > 3000)
+                  && Time.elapsed() > 3000
+                  && mainThread->info_due(false))
                   sync_cout << UCI::pv(rootPos, rootDepth, alpha, beta) << sync_endl;
 
               // In case of failing low/high increase aspiration window and
@@ -492,7 +511,8 @@ void Thread::search() {
           std::stable_sort(rootMoves.begin() + pvFirst, rootMoves.begin() + pvIdx + 1);
 
           if (    mainThread
-              && (Threads.stop || pvIdx + 1 == multiPV || Time.elapsed() > 3000))
+              && (Threads.stop || pvIdx + 1 == multiPV || Time.elapsed() > 3000)
+              && mainThread->info_due(Threads.stop || pvIdx + 1 == multiPV))
               sync_cout << UCI::pv(rootPos, rootDepth, alpha, beta) << sync_endl;
       }
 
@@ -755,7 +775,7 @@ namespace {
     // position key in case of an excluded move.
     excludedMove = ss->excludedMove;
     posKey = excludedMove == MOVE_NONE ? pos.key() : pos.key() ^ make_key(excludedMove);
-    tte = TT.probe(posKey, ss->ttHit);
+    tte = TT.probe(posKey, ss->ttHit, thisThread->ttStats);
     ttValue = ss->ttHit ? value_from_tt(tte->value(), ss->ply, pos.rule50_count()) : VALUE_NONE;
     ttMove =  rootNode ? thisThread->rootMoves[thisThread->pvIdx].pv[0]
             : ss->ttHit    ? tte->move() : MOVE_NONE;
@@ -817,11 +837,35 @@ namespace {
     {
         int piecesCount = pos.count<ALL_PIECES>();
 
-        if (    piecesCount <= TB::Cardinality
-            && (piecesCount <  TB::Cardinality || depth >= TB::ProbeDepth)
-            &&  pos.rule50_count() == 0
-            &&  Options["UCI_Variant"] == "chess"
-            && !pos.can_castle(ANY_CASTLING))
+        // Generated tables store the distance to mate, so their values are exact.
+        // The probe fails when the n-move rule could interfere.
+        if (    TB::UseFairy
+            &&  piecesCount <= TB::Cardinality
+            && (piecesCount <  TB::Cardinality || depth >= TB::ProbeDepth))
+        {
+            TB::ProbeState err;
+            value = TB::Fairy::probe(pos, ss->ply, &err);
+
+            // Force check of time on the next occasion
+            if (thisThread == Threads.main())
+                static_cast<MainThread*>(thisThread)->callsCnt = 0;
+
+            if (err != TB::ProbeState::FAIL)
+            {
+                thisThread->tbHits.fetch_add(1, std::memory_order_relaxed);
+
+                tte->save(posKey, value_to_tt(value, ss->ply), ss->ttPv, BOUND_EXACT,
+                          std::min(MAX_PLY - 1, depth + 6),
+                          MOVE_NONE, VALUE_NONE);
+
+                return value;
+            }
+        }
+        else if (    piecesCount <= TB::Cardinality
+                 && (piecesCount <  TB::Cardinality || depth >= TB::ProbeDepth)
+                 &&  pos.rule50_count() == 0
+                 && !TB::UseFairy
+                 && !pos.can_castle(ANY_CASTLING))
         {
             TB::ProbeState err;
             TB::WDLScore wdl = Tablebases::probe_wdl(pos, &err);
@@ -928,7 +972,10 @@ namespace {
         &&  depth < 9 - 3 * pos.blast_on_capture()
         &&  eval - futility_margin(depth, improving) * (1 + pos.check_counting() + 2 * pos.must_capture() + pos.extinction_single_piece() + !pos.checking_permitted()) >= beta
         &&  eval < VALUE_KNOWN_WIN) // Do not return unproven wins
+    {
+        thisThread->counters.inc(CNT_FUTILITY);
         return eval;
+    }
 
     // Step 8. Null move search with verification search (~40 Elo)
     if (   !PvNode
@@ -960,6 +1007,8 @@ namespace {
 
         if (nullValue >= beta)
         {
+            thisThread->counters.inc(CNT_NULL_MOVE);
+
             // Do not return unproven mate or TB scores
             if (nullValue >= VALUE_TB_WIN_IN_MAX_PLY)
                 nullValue = beta;
@@ -1044,6 +1093,7 @@ namespace {
                         tte->save(posKey, value_to_tt(value, ss->ply), ttPv,
                             BOUND_LOWER,
                             depth - 3, move, ss->staticEval);
+                    thisThread->counters.inc(CNT_PROBCUT);
                     return value;
                 }
             }
@@ -1120,11 +1170,15 @@ moves_loop: // When in check, search starts from here
 
       // Check for legality
       if (!rootNode && !pos.legal(move))
+      {
+          thisThread->counters.inc(CNT_ILLEGAL);
           continue;
+      }
 
       ss->moveCount = ++moveCount;
 
-      if (rootNode && thisThread == Threads.main() && Time.elapsed() > 3000 && is_uci_dialect(CurrentProtocol))
+      if (   rootNode && thisThread == Threads.main() && Time.elapsed() > 3000 && is_uci_dialect(CurrentProtocol)
+          && Threads.main()->info_due(false))
           sync_cout << "info depth " << depth
                     << " currmove " << UCI::move(pos, move)
                     << " currmovenumber " << moveCount + thisThread->pvIdx << sync_endl;
@@ -1161,11 +1215,17 @@ moves_loop: // When in check, search starts from here
               if (   !givesCheck
                   && lmrDepth < 1
                   && captureHistory[movedPiece][to_sq(move)][type_of(pos.piece_on(to_sq(move)))] < 0)
+              {
+                  thisThread->counters.inc(CNT_SHALLOW_PRUNING);
                   continue;
+              }
 
               // SEE based pruning
               if (!pos.see_ge(move, Value(-218 - 120 * pos.captures_to_hand()) * depth)) // (~25 Elo)
+              {
+                  thisThread->counters.inc(CNT_SHALLOW_PRUNING);
                   continue;
+              }
           }
           else
           {
@@ -1173,7 +1233,10 @@ moves_loop: // When in check, search starts from here
               if (   lmrDepth < 5
                   && (*contHist[0])[history_slot(movedPiece)][to_sq(move)] < CounterMovePruneThreshold
                   && (*contHist[1])[history_slot(movedPiece)][to_sq(move)] < CounterMovePruneThreshold)
+              {
+                  thisThread->counters.inc(CNT_SHALLOW_PRUNING);
                   continue;
+              }
 
               // Futility pruning: parent node (~5 Elo)
               if (   lmrDepth < 7
@@ -1184,11 +1247,17 @@ moves_loop: // When in check, search starts from here
                     + (*contHist[1])[history_slot(movedPiece)][to_sq(move)]
                     + (*contHist[3])[history_slot(movedPiece)][to_sq(move)]
                     + (*contHist[5])[history_slot(movedPiece)][to_sq(move)] / 3 < 28255)
+              {
+                  thisThread->counters.inc(CNT_SHALLOW_PRUNING);
                   continue;
+              }
 
               // Prune moves with negative SEE (~20 Elo)
               if (!(pos.walling_rule() == DUCK) && !pos.see_ge(move, Value(-(30 - std::min(lmrDepth, 18) + 10 * !!pos.flag_region(pos.side_to_move())) * lmrDepth * lmrDepth)))
+              {
+                  thisThread->counters.inc(CNT_SHALLOW_PRUNING);
                   continue;
+              }
           }
       }
 
@@ -1344,6 +1413,9 @@ moves_loop: // When in check, search starts from here
           // to be searched deeper than the first move, unless ttMove was extended by 2.
           Depth d = std::clamp(newDepth - r, 1, newDepth + (r < -1 && moveCount <= 5 && !doubleExtension));
 
+          if (d < newDepth)
+              thisThread->counters.inc(CNT_LMR);
+
           value = -search<NonPV>(pos, ss+1, -(alpha+1), -alpha, d, true);
 
           // If the son is reduced and fails high it will be re-searched at full depth
@@ -1564,7 +1636,7 @@ moves_loop: // When in check, search starts from here
                                                   : DEPTH_QS_NO_CHECKS;
     // Transposition table lookup
     posKey = pos.key();
-    tte = TT.probe(posKey, ss->ttHit);
+    tte = TT.probe(posKey, ss->ttHit, thisThread->ttStats);
     ttValue = ss->ttHit ? value_from_tt(tte->value(), ss->ply, pos.rule50_count()) : VALUE_NONE;
     ttMove = ss->ttHit ? tte->move() : MOVE_NONE;
     pvHit = ss->ttHit && tte->is_pv();
@@ -1662,12 +1734,14 @@ moves_loop: // When in check, search starts from here
           if (futilityValue <= alpha)
           {
               bestValue = std::max(bestValue, futilityValue);
+              thisThread->counters.inc(CNT_QS_PRUNING);
               continue;
           }
 
           if (futilityBase <= alpha && !pos.see_ge(move, VALUE_ZERO + 1))
           {
               bestValue = std::max(bestValue, futilityBase);
+              thisThread->counters.inc(CNT_QS_PRUNING);
               continue;
           }
       }
@@ -1675,7 +1749,10 @@ moves_loop: // When in check, search starts from here
       // Do not search moves with negative SEE values
       if (    bestValue > VALUE_TB_LOSS_IN_MAX_PLY
           && !pos.see_ge(move))
+      {
+          thisThread->counters.inc(CNT_QS_PRUNING);
           continue;
+      }
 
       // Speculative prefetch as early as possible
       prefetch(TT.first_entry(pos.key_after(move)));
@@ -1683,6 +1760,7 @@ moves_loop: // When in check, search starts from here
       // Check for legality just before making the move
       if (!pos.legal(move))
       {
+          thisThread->counters.inc(CNT_ILLEGAL);
           moveCount--;
           continue;
       }
@@ -1947,6 +2025,24 @@ moves_loop: // When in check, search starts from here
 } // namespace
 
 
+/// MainThread::info_due() limits intermediate search output, i.e. PV updates
+/// of aspiration re-searches and MultiPV lines as well as currmove lines, to
+/// one per "Info Interval" milliseconds. Since every PV update prints all
+/// lines, skipped updates are merged into the next one. Forced output, like
+/// the PV at the end of an iteration, is always sent.
+
+bool MainThread::info_due(bool force) {
+
+  TimePoint elapsed = Time.elapsed();
+
+  if (!force && elapsed - lastOutputTime < infoInterval)
+      return false;
+
+  lastOutputTime = elapsed;
+  return true;
+}
+
+
 /// MainThread::check_time() is used to print debug info and, more importantly,
 /// to detect when we are out of available time and thus stop the search.
 
@@ -1994,9 +2090,11 @@ string UCI::pv(const Position& pos, Depth depth, Value alpha, Value beta) {
   TimePoint elapsed = Time.elapsed() + 1;
   const RootMoves& rootMoves = pos.this_thread()->rootMoves;
   size_t pvIdx = pos.this_thread()->pvIdx;
-  size_t multiPV = std::min((size_t)Options["MultiPV"], rootMoves.size());
+  size_t multiPV = std::min(Settings.multiPV, rootMoves.size());
   uint64_t nodesSearched = Threads.nodes_searched();
   uint64_t tbHits = Threads.tb_hits() + (TB::RootInTB ? rootMoves.size() : 0);
+  bool showWDL = Settings.showWDL;
+  int hashfull = elapsed > 1000 ? TT.hashfull() : 0; // Earlier makes little sense
 
   for (size_t i = 0; i < multiPV; ++i)
   {
@@ -2040,7 +2138,7 @@ string UCI::pv(const Position& pos, Depth depth, Value alpha, Value beta) {
          << " multipv "  << i + 1
          << " score "    << UCI::value(v);
 
-      if (Options["UCI_ShowWDL"])
+      if (showWDL)
           ss << UCI::wdl(v, pos.game_ply());
 
       if (!tb && i == pvIdx)
@@ -2049,8 +2147,8 @@ string UCI::pv(const Position& pos, Depth depth, Value alpha, Value beta) {
       ss << " nodes "    << nodesSearched
          << " nps "      << nodesSearched * 1000 / elapsed;
 
-      if (elapsed > 1000) // Earlier makes little sense
-          ss << " hashfull " << TT.hashfull();
+      if (elapsed > 1000)
+          ss << " hashfull " << hashfull;
 
       ss << " tbhits "   << tbHits
          << " time "     << elapsed
@@ -2083,7 +2181,7 @@ bool RootMove::extract_ponder_from_tt(Position& pos) {
         return false;
 
     pos.do_move(pv[0], st);
-    TTEntry* tte = TT.probe(pos.key(), ttHit);
+    TTEntry* tte = TT.probe(pos.key(), ttHit, pos.this_thread()->ttStats);
 
     if (ttHit)
     {
@@ -2104,15 +2202,22 @@ void Tablebases::rank_root_moves(Position& pos, Search::RootMoves& rootMoves) {
     Cardinality = int(Options["SyzygyProbeLimit"]);
     bool dtz_available = true;
 
+    // Generated tables are used unless Syzygy tables are available
+    UseFairy = !Settings.chessVariant || !MaxCardinality;
+    int maxCardinality = UseFairy ? Fairy::MaxCardinality : MaxCardinality;
+
     // Tables with fewer pieces than SyzygyProbeLimit are searched with
     // ProbeDepth == DEPTH_ZERO
-    if (Cardinality > MaxCardinality)
+    if (Cardinality > maxCardinality)
     {
-        Cardinality = MaxCardinality;
+        Cardinality = maxCardinality;
         ProbeDepth = 0;
     }
 
-    if (Cardinality >= popcount(pos.pieces()) && !pos.can_castle(ANY_CASTLING))
+    if (!UseFairy && Options["SyzygyWarmup"])
+        warm_up(pos, Cardinality);
+
+    if (!UseFairy && Cardinality >= popcount(pos.pieces()) && !pos.can_castle(ANY_CASTLING))
     {
         // Rank moves using DTZ tables
         RootInTB = root_probe(pos, rootMoves);
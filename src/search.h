@@ -105,7 +105,22 @@ struct LimitsType {
 
 extern LimitsType Limits;
 
+
+/// SettingsType struct caches the option values needed in hot code, so that
+/// they are not looked up in the options map at every node. It is refreshed
+/// by read_settings() when a search starts and when these options change.
+
+struct SettingsType {
+  bool chessVariant;
+  bool tsumeMode;
+  bool showWDL;
+  size_t multiPV;
+};
+
+extern SettingsType Settings;
+
 void init();
+void read_settings();
 void clear();
 
 } // namespace Search
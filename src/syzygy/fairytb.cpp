@@ -0,0 +1,970 @@
+/*
+  Stockfish, a UCI chess playing engine derived from Glaurung 2.1
+  Copyright (C) 2004-2022 The Stockfish developers (see AUTHORS file)
+
+  Stockfish is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Stockfish is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>   // For std::memcpy
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+#include "../bitboard.h"
+#include "../misc.h"
+#include "../movegen.h"
+#include "../position.h"
+#include "../thread.h"
+#include "../types.h"
+#include "../uci.h"
+#include "../variant.h"
+
+#include "tbprobe.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#else
+#define WIN32_LEAN_AND_MEAN
+#ifndef NOMINMAX
+#  define NOMINMAX // Disable macros min() and max()
+#endif
+#include <windows.h>
+#endif
+
+using namespace Stockfish::Tablebases;
+
+int Stockfish::Tablebases::Fairy::MaxCardinality;
+
+namespace Stockfish {
+
+namespace {
+
+constexpr int TBPIECES = 6;                       // Max number of pieces of a table
+constexpr uint64_t MaxEntries = uint64_t(1) << 24; // Max number of positions of a table
+constexpr int BlockSize = 256;                    // Entries per block of packed entries
+constexpr uint32_t Magic = 0x31425446;            // "FTB1"
+constexpr uint32_t External = 1u << 31;           // Edge to a position of another table
+
+// Entries are 0 for draws, odd for wins and even for losses of the side to move.
+// The number of plies to mate is (entry - 1) / 2.
+constexpr uint16_t win_in(int plies)  { return uint16_t(2 * plies + 1); }
+constexpr uint16_t loss_in(int plies) { return uint16_t(2 * plies + 2); }
+constexpr int plies_of(uint16_t e) { return (e - 1) / 2; }
+constexpr bool is_win(uint16_t e) { return e & 1; }
+
+// A file starts with a header and a directory of its tables, followed by the
+// tables. Each table is a block index followed by the entries, bit-packed per
+// block relative to the smallest entry of the block. All values are stored in
+// native byte order and every table starts at an offset aligned to 8 bytes.
+struct FileHeader {
+  uint32_t magic;
+  uint32_t tableCount;
+  uint32_t files;
+  uint32_t ranks;
+};
+
+struct DirEntry {
+  char pieces[16]; // Piece characters in index order, zero terminated
+  uint64_t offset;
+  uint64_t size;   // Number of entries
+  uint64_t bytes;
+};
+
+struct Block {
+  uint32_t offset; // Byte offset of the packed entries
+  uint16_t base;   // Smallest entry of the block
+  uint8_t bits;    // Bits per packed entry, 0 if all entries are equal to base
+  uint8_t padding;
+};
+
+// Table holds the packed entries of one set of pieces. Positions are indexed by
+// the side to move and by the square of each piece within its domain, the first
+// piece varying fastest. Identical pieces are indexed in ascending square order.
+struct Table {
+  std::vector<Piece> pieces;
+  std::string name;
+  Key key;
+  uint64_t size;
+  uint64_t bytes;
+  const Block* blocks;
+  const uint8_t* data;
+
+  uint16_t entry(uint64_t idx) const {
+    const Block& b = blocks[idx / BlockSize];
+    if (!b.bits)
+        return b.base;
+
+    uint64_t bit = (idx % BlockSize) * b.bits;
+    uint64_t w;
+    std::memcpy(&w, data + b.offset + bit / 8, sizeof(w));
+    return uint16_t(b.base + ((w >> (bit % 8)) & ((1 << b.bits) - 1)));
+  }
+};
+
+// TableSet holds the tables of the current variant, either mapped from a file
+// or kept in memory while generating. The domain of a piece are the squares it
+// can stand on, i.e. the board or its mobility region.
+struct TableSet {
+  const Variant* var = nullptr;
+  std::unordered_map<Key, Table> tables;
+  std::vector<std::vector<uint8_t>> buffers;
+  std::vector<Square> domain[PIECE_NB];
+  int16_t domainIndex[PIECE_NB][SQUARE_NB];
+  void* baseAddress = nullptr;
+  uint64_t mapping = 0;
+
+  ~TableSet() { clear(); }
+
+  void init(const Variant* v);
+  void clear();
+  const Table* find(Key key) const;
+  int64_t index(const std::vector<Piece>& pieces, const Position& pos) const;
+  uint64_t size(const std::vector<Piece>& pieces) const;
+  bool map(const std::string& fname, bool mapped);
+  void add(const std::vector<Piece>& pieces, uint64_t size, const uint8_t* base, uint64_t bytes);
+};
+
+TableSet TBTables;
+
+// Tables index the pieces on the board only, so variants with pieces in hand
+// or with rules depending on state outside of the board are not supported.
+// Generation treats cycles as draws, so repetitions have to be draws as well,
+// which excludes perpetual check and chasing rules.
+bool is_supported(const Variant* v) {
+
+  return    v
+        && !v->pieceDrops
+        && !v->twoBoards
+        && !v->gating
+        && !v->seirawanGating
+        &&  v->wallingRule == NO_WALLING
+        && !v->petrifyOnCaptureTypes
+        &&  v->flipEnclosedPieces == NO_ENCLOSING
+        && !v->cambodianMoves
+        &&  v->multimoves.empty()
+        && !v->checkCounting
+        &&  v->countingRule == NO_COUNTING
+        && !v->makpongRule
+        && !v->shatarMateRule
+        && !v->bikjangRule
+        && !v->castlingWins
+        && !v->extinctionPseudoRoyal
+        &&  v->nFoldValue == VALUE_DRAW
+        && !v->perpetualCheckIllegal
+        && !v->moveRepetitionIllegal
+        &&  v->chasingRule == NO_CHASING;
+}
+
+// Pieces are sorted by color and by descending piece type, e.g. KRvK
+bool piece_order(Piece a, Piece b) {
+  return color_of(a) != color_of(b) ? color_of(a) < color_of(b) : type_of(a) > type_of(b);
+}
+
+std::string material_name(const Variant* v, const std::vector<Piece>& pieces) {
+
+  std::string name;
+  for (Color c : { WHITE, BLACK })
+  {
+      if (c == BLACK)
+          name += 'v';
+      for (Piece pc : pieces)
+          if (color_of(pc) == c)
+              name += v->pieceToChar[make_piece(WHITE, type_of(pc))];
+  }
+  return name;
+}
+
+// Parses a material signature, e.g. KRvK, with the pieces of both sides in upper case
+bool parse_material(const Variant* v, const std::string& name, std::vector<Piece>& pieces) {
+
+  Color c = WHITE;
+  pieces.clear();
+  for (char ch : name)
+  {
+      size_t idx;
+      if (ch == 'v' && c == WHITE)
+          c = BLACK;
+      else if (   (idx = v->pieceToChar.find(ch)) != std::string::npos
+               && color_of(Piece(idx)) == WHITE
+               && (v->pieceTypes & type_of(Piece(idx))))
+          pieces.push_back(make_piece(c, type_of(Piece(idx))));
+      else
+          return false;
+  }
+  std::sort(pieces.begin(), pieces.end(), piece_order);
+  return c == BLACK && pieces.size() <= TBPIECES;
+}
+
+std::string fen(const Variant* v, const std::vector<Piece>& pieces, const Square* squares, Color stm) {
+
+  Piece board[SQUARE_NB] = {};
+  for (size_t i = 0; i < pieces.size(); ++i)
+      board[squares[i]] = pieces[i];
+
+  std::string s;
+  for (Rank r = v->maxRank; r >= RANK_1; --r)
+  {
+      int emptyCnt = 0;
+      for (File f = FILE_A; f <= v->maxFile; ++f)
+      {
+          Piece pc = board[make_square(f, r)];
+          if (pc == NO_PIECE)
+              ++emptyCnt;
+          else
+          {
+              if (emptyCnt)
+                  s += std::to_string(emptyCnt), emptyCnt = 0;
+              s += v->pieceToChar[pc];
+          }
+      }
+      if (emptyCnt)
+          s += std::to_string(emptyCnt);
+      if (r > RANK_1)
+          s += '/';
+  }
+  return s + (stm == WHITE ? " w - - 0 1" : " b - - 0 1");
+}
+
+// The material key of a set of pieces is taken from a position with the
+// pieces on arbitrary squares.
+Key material_key(const Variant* v, const std::vector<Piece>& pieces) {
+
+  Square squares[TBPIECES];
+  Bitboard b = board_size_bb(v->maxFile, v->maxRank);
+  for (size_t i = 0; i < pieces.size(); ++i)
+      squares[i] = pop_lsb(b);
+
+  Position pos;
+  StateInfo st;
+  return pos.set(v, fen(v, pieces, squares, WHITE), false, &st, Threads.main()).material_key();
+}
+
+void TableSet::init(const Variant* v) {
+
+  clear();
+  var = v;
+  for (Piece pc = NO_PIECE; pc < PIECE_NB; ++pc)
+  {
+      domain[pc].clear();
+      std::fill(std::begin(domainIndex[pc]), std::end(domainIndex[pc]), -1);
+  }
+
+  for (Color c : { WHITE, BLACK })
+      for (PieceSet ps = v->pieceTypes; ps;)
+      {
+          PieceType pt = pop_lsb(ps);
+          Piece pc = make_piece(c, pt);
+          Bitboard b = board_size_bb(v->maxFile, v->maxRank);
+          if (v->mobilityRegion[c][pt])
+              b &= v->mobilityRegion[c][pt];
+          while (b)
+          {
+              Square s = pop_lsb(b);
+              domainIndex[pc][s] = int16_t(domain[pc].size());
+              domain[pc].push_back(s);
+          }
+      }
+}
+
+void TableSet::clear() {
+
+  tables.clear();
+  buffers.clear();
+
+  if (!baseAddress)
+      return;
+
+#ifndef _WIN32
+  munmap(baseAddress, mapping);
+#else
+  UnmapViewOfFile(baseAddress);
+  CloseHandle((HANDLE)mapping);
+#endif
+  baseAddress = nullptr;
+}
+
+const Table* TableSet::find(Key key) const {
+  auto it = tables.find(key);
+  return it != tables.end() ? &it->second : nullptr;
+}
+
+uint64_t TableSet::size(const std::vector<Piece>& pieces) const {
+
+  uint64_t size = 2;
+  for (Piece pc : pieces)
+      if ((size *= domain[pc].size()) > MaxEntries)
+          break;
+  return size;
+}
+
+// Returns the index of a position with the given pieces, or -1 if a piece is
+// outside of its domain.
+int64_t TableSet::index(const std::vector<Piece>& pieces, const Position& pos) const {
+
+  uint64_t idx = pos.side_to_move(), factor = 2;
+  for (size_t i = 0; i < pieces.size(); )
+  {
+      Piece pc = pieces[i];
+      Bitboard b = pos.pieces(color_of(pc), type_of(pc));
+      for ( ; i < pieces.size() && pieces[i] == pc; ++i)
+      {
+          int d = b ? domainIndex[pc][pop_lsb(b)] : -1;
+          if (d < 0)
+              return -1;
+          idx += d * factor;
+          factor *= domain[pc].size();
+      }
+  }
+  return int64_t(idx);
+}
+
+void TableSet::add(const std::vector<Piece>& pieces, uint64_t size, const uint8_t* base, uint64_t bytes) {
+
+  Table t;
+  t.pieces = pieces;
+  t.name = material_name(var, pieces);
+  t.key = material_key(var, pieces);
+  t.size = size;
+  t.bytes = bytes;
+  t.blocks = reinterpret_cast<const Block*>(base);
+  t.data = base + (size + BlockSize - 1) / BlockSize * sizeof(Block);
+  tables[t.key] = t;
+}
+
+// Reads the tables of a file, either by memory mapping it or by reading it
+// into memory. Tables that do not match the current variant are skipped.
+bool TableSet::map(const std::string& fname, bool mapped) {
+
+  const uint8_t* data;
+  uint64_t fileSize;
+
+  if (mapped)
+  {
+#ifndef _WIN32
+      struct stat statbuf;
+      int fd = ::open(fname.c_str(), O_RDONLY);
+
+      if (fd == -1)
+          return false;
+
+      fstat(fd, &statbuf);
+      mapping = fileSize = statbuf.st_size;
+      baseAddress = fileSize ? mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+#if defined(MADV_RANDOM)
+      if (baseAddress != MAP_FAILED)
+          madvise(baseAddress, fileSize, MADV_RANDOM);
+#endif
+      ::close(fd);
+
+      if (baseAddress == MAP_FAILED)
+          return baseAddress = nullptr, false;
+#else
+      HANDLE fd = CreateFile(fname.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                             OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+
+      if (fd == INVALID_HANDLE_VALUE)
+          return false;
+
+      DWORD size_high;
+      DWORD size_low = GetFileSize(fd, &size_high);
+      fileSize = (uint64_t(size_high) << 32) | size_low;
+      HANDLE mmap = CreateFileMapping(fd, nullptr, PAGE_READONLY, size_high, size_low, nullptr);
+      CloseHandle(fd);
+
+      if (!mmap)
+          return false;
+
+      mapping = (uint64_t)mmap;
+      baseAddress = MapViewOfFile(mmap, FILE_MAP_READ, 0, 0, 0);
+
+      if (!baseAddress)
+      {
+          CloseHandle(mmap);
+          return false;
+      }
+#endif
+      data = static_cast<const uint8_t*>(baseAddress);
+  }
+  else
+  {
+      std::ifstream file(fname, std::ios::binary);
+      if (!file)
+          return false;
+
+      std::vector<uint8_t> buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+      fileSize = buffer.size();
+      buffers.push_back(std::move(buffer));
+      data = buffers.back().data();
+  }
+
+  FileHeader header;
+  if (fileSize < sizeof(header))
+      return false;
+
+  std::memcpy(&header, data, sizeof(header));
+  if (   header.magic != Magic
+      || header.files != uint32_t(var->maxFile + 1)
+      || header.ranks != uint32_t(var->maxRank + 1)
+      || fileSize < sizeof(header) + header.tableCount * sizeof(DirEntry))
+  {
+      sync_cout << "info string Invalid tablebase file " << fname << sync_endl;
+      return false;
+  }
+
+  for (uint32_t i = 0; i < header.tableCount; ++i)
+  {
+      DirEntry e;
+      std::memcpy(&e, data + sizeof(header) + i * sizeof(DirEntry), sizeof(e));
+      e.pieces[sizeof(e.pieces) - 1] = 0;
+
+      std::vector<Piece> pieces;
+      size_t idx;
+      for (const char* p = e.pieces; *p; ++p)
+          if ((idx = var->pieceToChar.find(*p)) != std::string::npos && (var->pieceTypes & type_of(Piece(idx))))
+              pieces.push_back(Piece(idx));
+
+      // Skip tables of pieces that changed since the file was written
+      if (   pieces.size() != std::strlen(e.pieces)
+          || pieces.size() > TBPIECES
+          || size(pieces) != e.size
+          || e.offset % 8
+          || e.offset + e.bytes > fileSize
+          || (e.size + BlockSize - 1) / BlockSize * sizeof(Block) > e.bytes)
+          continue;
+
+      add(pieces, e.size, data + e.offset, e.bytes);
+  }
+
+  return true;
+}
+
+// Returns the file of the tables of the current variant in the given directories
+std::string find_file(const std::string& paths, const std::string& name) {
+
+#ifndef _WIN32
+  constexpr char SepChar = ':';
+#else
+  constexpr char SepChar = ';';
+#endif
+  std::stringstream ss(paths);
+  std::string path;
+
+  std::string first;
+
+  while (std::getline(ss, path, SepChar))
+  {
+      if (std::ifstream(path + "/" + name))
+          return path + "/" + name;
+      if (first.empty())
+          first = path;
+  }
+
+  return first + "/" + name;
+}
+
+bool write_file(const TableSet& set, const std::string& fname) {
+
+  std::vector<const Table*> tables;
+  for (const auto& it : set.tables)
+      tables.push_back(&it.second);
+
+  std::sort(tables.begin(), tables.end(), [](const Table* a, const Table* b) {
+      return a->pieces.size() != b->pieces.size() ? a->pieces.size() < b->pieces.size() : a->name < b->name;
+  });
+
+  FileHeader header = { Magic, uint32_t(tables.size()), uint32_t(set.var->maxFile + 1), uint32_t(set.var->maxRank + 1) };
+  uint64_t offset = sizeof(header) + tables.size() * sizeof(DirEntry);
+  std::vector<DirEntry> dir;
+
+  for (const Table* t : tables)
+  {
+      DirEntry e = {};
+      for (size_t i = 0; i < t->pieces.size(); ++i)
+          e.pieces[i] = set.var->pieceToChar[t->pieces[i]];
+      offset = (offset + 7) / 8 * 8;
+      e.offset = offset;
+      e.size = t->size;
+      e.bytes = t->bytes;
+      offset += t->bytes;
+      dir.push_back(e);
+  }
+
+  std::ofstream file(fname, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(dir.data()), dir.size() * sizeof(DirEntry));
+
+  for (size_t i = 0; i < tables.size(); ++i)
+  {
+      while (uint64_t(file.tellp()) < dir[i].offset)
+          file.put(0);
+      file.write(reinterpret_cast<const char*>(tables[i]->blocks), tables[i]->bytes);
+  }
+
+  return bool(file);
+}
+
+// Packs the entries of a table into blocks of bit-packed entries
+std::vector<uint8_t> pack(const std::vector<uint16_t>& entries, uint64_t size) {
+
+  size_t blockCount = (size + BlockSize - 1) / BlockSize;
+  std::vector<Block> blocks(blockCount);
+  std::vector<uint8_t> data;
+
+  for (size_t i = 0; i < blockCount; ++i)
+  {
+      auto first = entries.begin() + i * BlockSize;
+      auto last = entries.begin() + std::min(uint64_t(i + 1) * BlockSize, size);
+      auto [lo, hi] = std::minmax_element(first, last);
+      int bits = 0;
+      while ((*hi - *lo) >> bits)
+          ++bits;
+
+      blocks[i] = { uint32_t(data.size()), *lo, uint8_t(bits), 0 };
+      size_t start = data.size();
+      data.resize(start + ((last - first) * bits + 7) / 8);
+
+      for (auto it = first; it != last; ++it)
+          for (int k = 0, bit = int(it - first) * bits; k < bits; ++k, ++bit)
+              if (((*it - *lo) >> k) & 1)
+                  data[start + bit / 8] |= uint8_t(1 << (bit % 8));
+  }
+
+  // Padding for reading packed entries as 64-bit words
+  data.resize(data.size() + 8);
+
+  std::vector<uint8_t> buffer(blockCount * sizeof(Block) + data.size());
+  std::memcpy(buffer.data(), blocks.data(), blockCount * sizeof(Block));
+  std::memcpy(buffer.data() + blockCount * sizeof(Block), data.data(), data.size());
+  return buffer;
+}
+
+// Generator builds tables by retrograde analysis over the graph of legal moves,
+// so that all rules of the variant apply. Moves to positions with other pieces,
+// i.e. captures and promotions, are resolved by generating their tables first.
+// Positions with en passant squares are not indexed and become extra nodes.
+// Rules depending on the history of the game, like repetitions and the n-move
+// rule, are ignored.
+class Generator {
+
+  TableSet& set;
+  std::vector<Key> pending;
+
+  struct Graph {
+    const std::vector<Piece>* pieces;
+    Key key;
+    uint64_t size;
+    std::vector<uint16_t> entries;
+    std::vector<uint32_t> first;
+    std::vector<uint32_t> edges;
+    std::vector<std::vector<uint32_t>> extraEdges;
+    std::unordered_map<Key, uint32_t> extras;
+    int maxExternal = 0;
+  };
+
+  bool expand(Graph& g, Position& pos, uint32_t node);
+  bool edge(Graph& g, Position& pos, uint32_t& child);
+
+public:
+  Generator(TableSet& s) : set(s) {}
+  bool build(std::vector<Piece> pieces);
+};
+
+uint16_t terminal_entry(Value result) {
+  return result > VALUE_DRAW ? win_in(0) : result < VALUE_DRAW ? loss_in(0) : 0;
+}
+
+// Records the moves of a position, or its result if the game has ended
+bool Generator::expand(Graph& g, Position& pos, uint32_t node) {
+
+  Value result;
+  if (pos.is_immediate_game_end(result))
+  {
+      g.entries[node] = terminal_entry(result);
+      return true;
+  }
+
+  MoveList<LEGAL> moves(pos);
+  if (!moves.size())
+  {
+      g.entries[node] = terminal_entry(pos.checkers() ? pos.checkmate_value() : pos.stalemate_value());
+      return true;
+  }
+
+  std::vector<uint32_t> children;
+  StateInfo st;
+
+  for (const auto& m : moves)
+  {
+      uint32_t child;
+      pos.do_move(m, st);
+      bool ok = edge(g, pos, child);
+      pos.undo_move(m);
+
+      if (!ok)
+          return false;
+
+      children.push_back(child);
+  }
+
+  if (node < g.size)
+      g.edges.insert(g.edges.end(), children.begin(), children.end());
+  else
+      g.extraEdges[node - g.size] = std::move(children);
+
+  return true;
+}
+
+bool Generator::edge(Graph& g, Position& pos, uint32_t& child) {
+
+  if (pos.ep_squares())
+  {
+      auto it = g.extras.find(pos.key());
+      if (it != g.extras.end())
+          return child = it->second, true;
+
+      child = uint32_t(g.size + g.extraEdges.size());
+      g.extras[pos.key()] = child;
+      g.entries.push_back(0);
+      g.extraEdges.emplace_back();
+      return expand(g, pos, child);
+  }
+
+  if (pos.material_key() == g.key)
+  {
+      int64_t idx = set.index(*g.pieces, pos);
+      return child = uint32_t(idx), idx >= 0;
+  }
+
+  const Table* t = set.find(pos.material_key());
+  if (!t)
+  {
+      std::vector<Piece> pieces;
+      for (Color c : { WHITE, BLACK })
+          for (PieceSet ps = set.var->pieceTypes; ps;)
+          {
+              PieceType pt = pop_lsb(ps);
+              pieces.insert(pieces.end(), pos.count(c, pt), make_piece(c, pt));
+          }
+
+      if (!build(pieces) || !(t = set.find(pos.material_key())))
+          return false;
+  }
+
+  int64_t idx = set.index(t->pieces, pos);
+  if (idx < 0)
+      return false;
+
+  uint16_t e = t->entry(idx);
+  if (e)
+      g.maxExternal = std::max(g.maxExternal, plies_of(e));
+  child = External | e;
+  return true;
+}
+
+bool Generator::build(std::vector<Piece> pieces) {
+
+  std::sort(pieces.begin(), pieces.end(), piece_order);
+  const Variant* v = set.var;
+  std::string name = material_name(v, pieces);
+
+  for (Piece pc : pieces)
+      if (v->pieceToChar[pc] == ' ' || v->pieceToChar[pc] == '+' || v->pieceToChar[pc] == '.')
+      {
+          sync_cout << "info string Can not generate " << name << ": unsupported piece" << sync_endl;
+          return false;
+      }
+
+  Key key = material_key(v, pieces);
+  if (set.find(key))
+      return true;
+
+  if (pieces.size() > TBPIECES || set.size(pieces) > MaxEntries)
+  {
+      sync_cout << "info string Can not generate " << name << ": too many positions" << sync_endl;
+      return false;
+  }
+
+  if (std::find(pending.begin(), pending.end(), key) != pending.end())
+  {
+      sync_cout << "info string Can not generate " << name << ": cyclic dependency" << sync_endl;
+      return false;
+  }
+
+  pending.push_back(key);
+
+  Graph g;
+  g.pieces = &pieces;
+  g.key = key;
+  g.size = set.size(pieces);
+  g.entries.resize(g.size);
+  g.first.resize(g.size + 1);
+
+  Position pos;
+  StateInfo st;
+  Square squares[TBPIECES];
+  bool ok = true;
+
+  for (uint64_t idx = 0; idx < g.size && ok; ++idx)
+  {
+      g.first[idx] = uint32_t(g.edges.size());
+
+      // Decode the squares, skipping positions with pieces on the same square
+      // or with identical pieces out of order.
+      Bitboard occupied = 0;
+      uint64_t rest = idx / 2;
+      bool valid = true;
+      for (size_t i = 0; i < pieces.size() && valid; ++i)
+      {
+          size_t d = rest % set.domain[pieces[i]].size();
+          rest /= set.domain[pieces[i]].size();
+          squares[i] = set.domain[pieces[i]][d];
+          valid =   !(occupied & squares[i])
+                 && (!i || pieces[i] != pieces[i - 1] || squares[i] > squares[i - 1]);
+          occupied |= squares[i];
+      }
+      if (!valid)
+          continue;
+
+      Color us = Color(idx & 1);
+      pos.set(v, fen(v, pieces, squares, us), false, &st, Threads.main());
+
+      // The side not to move can not be in check
+      if (pos.count<KING>(~us) && pos.attackers_to(pos.square<KING>(~us), us))
+          continue;
+
+      ok = expand(g, pos, uint32_t(idx));
+  }
+  g.first[g.size] = uint32_t(g.edges.size());
+
+  pending.pop_back();
+
+  if (!ok || g.edges.size() >= External)
+  {
+      sync_cout << "info string Can not generate " << name << ": unresolved positions" << sync_endl;
+      return false;
+  }
+
+  // Positions are resolved in order of their distance to mate. A position is
+  // won if a move reaches a position that is lost in fewer plies, and lost if
+  // all moves reach positions that are won in fewer plies.
+  std::vector<uint32_t> unresolved;
+  for (uint32_t n = 0; n < g.entries.size(); ++n)
+      if (   !g.entries[n]
+          && (n < g.size ? g.first[n] < g.first[n + 1] : !g.extraEdges[n - g.size].empty()))
+          unresolved.push_back(n);
+
+  int maxPlies = 0;
+  for (int plies = 1; !unresolved.empty(); ++plies)
+  {
+      size_t kept = 0;
+      for (uint32_t n : unresolved)
+      {
+          const uint32_t* begin = n < g.size ? g.edges.data() + g.first[n] : g.extraEdges[n - g.size].data();
+          const uint32_t* end = n < g.size ? g.edges.data() + g.first[n + 1] : begin + g.extraEdges[n - g.size].size();
+          bool win = false, loss = true;
+
+          for (const uint32_t* c = begin; c < end && !win; ++c)
+          {
+              uint16_t e = *c & External ? uint16_t(*c) : g.entries[*c];
+              if (e && plies_of(e) < plies)
+                  win = !is_win(e);
+              else
+                  loss = false;
+          }
+
+          if (win || loss)
+              g.entries[n] = win ? win_in(plies) : loss_in(plies), maxPlies = plies;
+          else
+              unresolved[kept++] = n;
+      }
+
+      if (kept == unresolved.size() && plies > g.maxExternal)
+          break;
+
+      unresolved.resize(kept);
+  }
+
+  std::vector<uint8_t> buffer = pack(g.entries, g.size);
+  set.buffers.push_back(std::move(buffer));
+  set.add(pieces, g.size, set.buffers.back().data(), set.buffers.back().size());
+
+  sync_cout << "info string Generated " << name << " with " << g.size
+            << " positions, longest mate in " << maxPlies << " plies" << sync_endl;
+
+  return true;
+}
+
+// Enumerates the sets of up to the given number of pieces, with one king per
+// side if the variant has kings.
+void enumerate(const Variant* v, int maxPieces, std::vector<std::vector<Piece>>& sets) {
+
+  std::vector<PieceType> types;
+  for (PieceSet ps = v->pieceTypes; ps;)
+  {
+      PieceType pt = pop_lsb(ps);
+      if (pt != KING)
+          types.push_back(pt);
+  }
+
+  bool kings = v->pieceTypes & KING;
+  std::vector<Piece> pieces;
+
+  std::function<void(Color, size_t)> add = [&](Color c, size_t from) {
+      int count[COLOR_NB] = {};
+      for (Piece pc : pieces)
+          count[color_of(pc)]++;
+
+      if (c == BLACK && (kings || (count[WHITE] && count[BLACK])))
+          sets.push_back(pieces);
+
+      if (c == WHITE)
+          add(BLACK, 0);
+
+      if (int(pieces.size()) >= maxPieces)
+          return;
+
+      for (size_t i = from; i < types.size(); ++i)
+      {
+          pieces.push_back(make_piece(c, types[i]));
+          add(c, i);
+          pieces.pop_back();
+      }
+  };
+
+  if (kings)
+      pieces = { W_KING, B_KING };
+  add(WHITE, 0);
+}
+
+} // namespace
+
+
+/// Tablebases::Fairy::init() maps the tables of the current variant. It is
+/// called together with Tablebases::init() and after every variant change.
+void Tablebases::Fairy::init(const std::string& paths) {
+
+  TBTables.clear();
+  MaxCardinality = 0;
+
+  const Variant* v = variants.find(Options["UCI_Variant"])->second;
+
+  if (paths.empty() || paths == "<empty>" || !is_supported(v))
+      return;
+
+  TBTables.init(v);
+  TBTables.map(find_file(paths, std::string(Options["UCI_Variant"]) + ".ftb"), true);
+
+  for (const auto& it : TBTables.tables)
+      MaxCardinality = std::max(int(it.second.pieces.size()), MaxCardinality);
+
+  if (!TBTables.tables.empty())
+      sync_cout << "info string Found " << TBTables.tables.size() << " tablebases for " << std::string(Options["UCI_Variant"]) << sync_endl;
+}
+
+
+/// Tablebases::Fairy::generate() adds the tables for the given material
+/// signatures, or for all sets of up to maxPieces pieces, to the tablebase
+/// file of the current variant in the first directory of SyzygyPath.
+void Tablebases::Fairy::generate(const std::vector<std::string>& materials, int maxPieces) {
+
+  const std::string paths = Options["SyzygyPath"];
+  const Variant* v = variants.find(Options["UCI_Variant"])->second;
+
+  if (paths.empty() || paths == "<empty>")
+  {
+      sync_cout << "info string Set SyzygyPath to generate tablebases" << sync_endl;
+      return;
+  }
+
+  if (!is_supported(v))
+  {
+      sync_cout << "info string Tablebases are not supported for this variant" << sync_endl;
+      return;
+  }
+
+  std::vector<std::vector<Piece>> sets;
+  for (const std::string& m : materials)
+  {
+      sets.emplace_back();
+      if (!parse_material(v, m, sets.back()))
+      {
+          sync_cout << "info string Invalid material " << m << sync_endl;
+          return;
+      }
+  }
+  if (materials.empty())
+      enumerate(v, std::min(maxPieces, TBPIECES), sets);
+
+  std::string fname = find_file(paths, std::string(Options["UCI_Variant"]) + ".ftb");
+  TimePoint start = now();
+
+  // Work on a copy in memory, the file is replaced afterwards
+  TBTables.init(v);
+  TBTables.map(fname, false);
+
+  Generator generator(TBTables);
+  size_t count = TBTables.tables.size();
+  for (const auto& pieces : sets)
+      generator.build(pieces);
+
+  if (TBTables.tables.size() > count && !write_file(TBTables, fname))
+      sync_cout << "info string Could not write " << fname << sync_endl;
+  else
+      sync_cout << "info string Generated " << TBTables.tables.size() - count << " tablebases in "
+                << (now() - start) / 1000 << "s" << sync_endl;
+
+  init(paths);
+}
+
+
+/// Tablebases::Fairy::probe() returns the value of a position in its table,
+/// a mate score adjusted to the given ply or a draw.
+Value Tablebases::Fairy::probe(const Position& pos, int ply, ProbeState* result) {
+
+  *result = FAIL;
+
+  const Table* t = TBTables.find(pos.material_key());
+  if (!t || pos.ep_squares() || pos.can_castle(ANY_CASTLING))
+      return VALUE_NONE;
+
+  int64_t idx = TBTables.index(t->pieces, pos);
+  if (idx < 0)
+      return VALUE_NONE;
+
+  uint16_t e = t->entry(idx);
+
+  // The n-move rule may draw the game before the stored mate is reached
+  if (e && pos.n_move_rule() && pos.rule50_count() + plies_of(e) > 2 * pos.n_move_rule())
+      return VALUE_NONE;
+
+  *result = OK;
+
+  if (!e)
+      return VALUE_DRAW;
+
+  // Mates beyond the search horizon are scored like Syzygy wins
+  int plies = std::min(ply + plies_of(e), MAX_PLY);
+  return is_win(e) ? (plies < MAX_PLY ? mate_in(plies) : VALUE_MATE_IN_MAX_PLY - ply - 1)
+                   : (plies < MAX_PLY ? mated_in(plies) : VALUE_MATED_IN_MAX_PLY + ply + 1);
+}
+
+} // namespace Stockfish
@@ -27,11 +27,14 @@
 #include <sstream>
 #include <type_traits>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 #include "../bitboard.h"
 #include "../movegen.h"
 #include "../position.h"
 #include "../search.h"
+#include "../thread.h"
 #include "../types.h"
 #include "../uci.h"
 
@@ -285,6 +288,20 @@ public:
         return data + 4; // Skip Magics's header
     }
 
+    // Hint the OS that the pages in [begin, end) will be accessed soon
+    static void willneed(const void* begin, const void* end) {
+
+#if !defined(_WIN32) && defined(MADV_WILLNEED)
+        const uintptr_t pageSize = uintptr_t(sysconf(_SC_PAGESIZE));
+        uintptr_t first = uintptr_t(begin) & ~(pageSize - 1);
+        if (uintptr_t(end) > first)
+            madvise((void*)first, uintptr_t(end) - first, MADV_WILLNEED);
+#else
+        (void)begin;
+        (void)end;
+#endif
+    }
+
     static void unmap(void* baseAddress, uint64_t mapping) {
 
 #ifndef _WIN32
@@ -334,6 +351,7 @@ struct TBTable {
     static constexpr int Sides = Type == WDL ? 2 : 1;
 
     std::atomic_bool ready;
+    std::atomic_bool warmed; // Mapped by warm_up() and not probed yet
     void* baseAddress;
     uint8_t* map;
     uint64_t mapping;
@@ -349,7 +367,7 @@ struct TBTable {
         return &items[stm % Sides][hasPawns ? f : 0];
     }
 
-    TBTable() : ready(false), baseAddress(nullptr) {}
+    TBTable() : ready(false), warmed(false), baseAddress(nullptr) {}
     explicit TBTable(const std::string& code);
     explicit TBTable(const TBTable<WDL>& wdl);
 
@@ -1096,8 +1114,10 @@ void set(T& e, uint8_t* data) {
         for (int k = 0; k < e.pieceCount; ++k, ++data)
             for (int i = 0; i < sides; i++)
             {
+                // Files use the chess piece codes, where 6 is the king
                 int p = i ? *data >>  4 : *data & 0xF;
-                e.get(i, f)->pieces[k] = make_piece(Color(p >> 3), PieceType(p & 7));
+                PieceType pt = (p & 7) == 6 ? KING : PieceType(p & 7);
+                e.get(i, f)->pieces[k] = make_piece(Color(p >> 3), pt);
             }
 
         for (int i = 0; i < sides; ++i)
@@ -1164,12 +1184,49 @@ void* mapped(TBTable<Type>& e, const Position& pos) {
     uint8_t* data = TBFile(fname).map(&e.baseAddress, &e.mapping, Type);
 
     if (data)
+    {
         set(e, data);
 
+        // Every probe goes through the sparse index and the block lengths,
+        // which precede the compressed data, so read them ahead at once
+        // instead of faulting them in page by page.
+        TBFile::willneed(e.items[0][0].sparseIndex, e.items[0][0].data);
+    }
+
     e.ready.store(true, std::memory_order_release);
     return e.baseAddress;
 }
 
+// Tables read ahead by warm_up() in the background, and the number of them
+// that were already mapped at their first probe.
+struct WarmupThread : std::thread {
+    using std::thread::operator=;
+    ~WarmupThread() { if (joinable()) join(); }
+} Warmer;
+std::atomic_bool Warming; // Set while the Warmer thread reads tables
+
+Key WarmedKey;
+std::atomic<uint64_t> StallsAvoided;
+constexpr int WarmupMargin = 2; // Pieces above the probe limit to start warming
+
+// Map the table and ask the OS to read the whole file ahead. Tables mapped
+// before are only read ahead again, since they may have been evicted.
+template<TBType Type>
+void warm(TBTable<Type>& e, const Position& pos) {
+
+    bool wasReady = e.ready.load(std::memory_order_acquire);
+
+    if (!mapped(e, pos))
+        return;
+
+#ifndef _WIN32 // The mapping is the file size on POSIX systems
+    TBFile::willneed(e.baseAddress, (uint8_t*)e.baseAddress + e.mapping);
+#endif
+
+    if (!wasReady)
+        e.warmed = true;
+}
+
 template<TBType Type, typename Ret = typename TBTable<Type>::Ret>
 Ret probe_table(const Position& pos, ProbeState* result, WDLScore wdl = WDLDraw) {
 
@@ -1181,6 +1238,9 @@ Ret probe_table(const Position& pos, ProbeState* result, WDLScore wdl = WDLDraw)
     if (!entry || !mapped(*entry, pos))
         return *result = FAIL, Ret();
 
+    if (entry->warmed.load(std::memory_order_relaxed) && entry->warmed.exchange(false))
+        ++StallsAvoided;
+
     return do_probe_table(pos, entry, wdl, result);
 }
 
@@ -1259,6 +1319,19 @@ WDLScore search(Position& pos, ProbeState* result) {
     return *result = OK, value;
 }
 
+// DTZCache keeps the results of recent successful DTZ probes, which are
+// repeated a lot by the recursion in probe_dtz() and across root moves.
+// Entries are written without locks by the root probing threads, so the
+// key is stored xor'ed with the value to detect torn entries.
+struct DTZEntry {
+    std::atomic<uint64_t> key, data;
+};
+
+constexpr size_t DTZCacheSize = 1 << 12;
+DTZEntry DTZCache[DTZCacheSize];
+
+int probe_dtz_table(Position& pos, ProbeState* result);
+
 } // namespace
 
 
@@ -1267,10 +1340,20 @@ WDLScore search(Position& pos, ProbeState* result) {
 /// safe, nor it needs to be.
 void Tablebases::init(const std::string& paths) {
 
+    if (Warmer.joinable())
+        Warmer.join();
+
     TBTables.clear();
     MaxCardinality = 0;
+    WarmedKey = 0;
+    StallsAvoided = 0;
+
+    for (DTZEntry& e : DTZCache)
+        e.key = e.data = 0;
     TBFile::Paths = paths;
 
+    Fairy::init(paths);
+
 #ifdef LARGEBOARDS
     // Tablebases are not working for large-board version
     return;
@@ -1414,6 +1497,84 @@ void Tablebases::init(const std::string& paths) {
     sync_cout << "info string Found " << TBTables.size() << " tablebases" << sync_endl;
 }
 
+// Tablebases::warm_up() maps the tables the search of the given position is
+// about to probe and reads them ahead in a background thread, so that the first
+// probes do not stall on the disk. Warming starts once the position is within
+// WarmupMargin pieces of the probe limit, and covers the tables at the limit
+// and one piece below it that can be reached by captures. While a previous
+// warm-up is still reading, no new one is started, so the search never waits.
+void Tablebases::warm_up(const Position& pos, int cardinality) {
+
+    int pieceCount = popcount(pos.pieces());
+
+    if (   pieceCount > cardinality + WarmupMargin
+        || pos.material_key() == WarmedKey
+        || Warming.load(std::memory_order_acquire))
+        return;
+
+    // The previous thread has finished, so joining it does not block
+    if (Warmer.joinable())
+        Warmer.join();
+
+    WarmedKey = pos.material_key();
+
+    // Enumerate the materials left after captures, counting the pieces of
+    // each type and color like an odometer.
+    constexpr int Slots = 2 * (QUEEN - PAWN + 1);
+    int maxCnt[Slots], cnt[Slots] = {};
+    int target = std::min(pieceCount, cardinality);
+    std::vector<std::string> codes;
+
+    for (Color c : { WHITE, BLACK })
+        for (PieceType pt = PAWN; pt <= QUEEN; ++pt)
+            maxCnt[c * (QUEEN - PAWN + 1) + pt - PAWN] = pos.count(c, pt);
+
+    for (int i = 0; i < Slots; )
+    {
+        int total = 2;
+        for (int n : cnt)
+            total += n;
+
+        if (total >= target - 1 && total <= target)
+        {
+            std::string code;
+            for (Color c : { WHITE, BLACK })
+            {
+                code += c == WHITE ? "K" : "vK";
+                for (PieceType pt = QUEEN; pt >= PAWN; --pt)
+                    code += std::string(cnt[c * (QUEEN - PAWN + 1) + pt - PAWN], PieceToChar[pt]);
+            }
+            codes.push_back(code);
+        }
+
+        for (i = 0; i < Slots && ++cnt[i] > maxCnt[i]; ++i)
+            cnt[i] = 0;
+    }
+
+    Warming = true;
+    Warmer = std::thread([codes]() {
+        for (const std::string& code : codes)
+        {
+            StateInfo st;
+            Position p;
+            p.set(code, WHITE, &st);
+
+            if (TBTable<WDL>* wdl = TBTables.get<WDL>(p.material_key()))
+                warm(*wdl, p);
+
+            if (TBTable<DTZ>* dtz = TBTables.get<DTZ>(p.material_key()))
+                warm(*dtz, p);
+        }
+        Warming.store(false, std::memory_order_release);
+    });
+}
+
+// Tablebases::stalls_avoided() returns the number of tables that were already
+// mapped by warm_up() when the search probed them first.
+uint64_t Tablebases::stalls_avoided() {
+    return StallsAvoided;
+}
+
 // Probe the WDL table for a particular position.
 // If *result != FAIL, the probe was successful.
 // The return value is from the point of view of the side to move:
@@ -1456,6 +1617,29 @@ WDLScore Tablebases::probe_wdl(Position& pos, ProbeState* result) {
 // then do not accept moves leading to dtz + 50-move-counter == 100.
 int Tablebases::probe_dtz(Position& pos, ProbeState* result) {
 
+    DTZEntry& e = DTZCache[pos.key() & (DTZCacheSize - 1)];
+    uint64_t data = e.data.load(std::memory_order_relaxed);
+
+    if ((e.key.load(std::memory_order_relaxed) ^ data) == pos.key())
+        return *result = OK, int(int32_t(data));
+
+    int dtz = probe_dtz_table(pos, result);
+
+    if (*result != FAIL)
+    {
+        data = uint64_t(uint32_t(dtz));
+        e.key.store(pos.key() ^ data, std::memory_order_relaxed);
+        e.data.store(data, std::memory_order_relaxed);
+    }
+
+    return dtz;
+}
+
+namespace {
+
+// Probe the DTZ table and resolve the cases where it cannot be used directly
+int probe_dtz_table(Position& pos, ProbeState* result) {
+
     *result = OK;
     WDLScore wdl = search<true>(pos, result);
 
@@ -1516,80 +1700,106 @@ int Tablebases::probe_dtz(Position& pos, ProbeState* result) {
     return minDTZ == 0xFFFF ? -1 : minDTZ;
 }
 
+} // namespace
+
 
 // Use the DTZ tables to rank root moves.
 //
 // A return value false indicates that not all probes were successful.
 bool Tablebases::root_probe(Position& pos, Search::RootMoves& rootMoves) {
 
-    ProbeState result;
-    StateInfo st;
-
     // Obtain 50-move counter for the root position
     int cnt50 = pos.rule50_count();
 
     // Check whether a position was repeated since the last zeroing move.
     bool rep = pos.has_repeated();
 
-    int dtz, bound = Options["Syzygy50MoveRule"] ? 900 : 1;
+    int bound = Options["Syzygy50MoveRule"] ? 900 : 1;
 
-    // Probe and rank each move
-    for (auto& m : rootMoves)
-    {
-        pos.do_move(m.pv[0], st);
+    std::atomic<bool> failed(false);
 
-        // Calculate dtz for the current move counting from the root position
-        if (pos.rule50_count() == 0)
-        {
-            // In case of a zeroing move, dtz is one of -101/-1/0/1/101
-            WDLScore wdl = -probe_wdl(pos, &result);
-            dtz = dtz_before_zeroing(wdl);
-        }
-        else if (pos.is_draw(1))
-        {
-            // In case a root move leads to a draw by repetition or
-            // 50-move rule, we set dtz to zero. Note: since we are
-            // only 1 ply from the root, this must be a true 3-fold
-            // repetition inside the game history.
-            dtz = 0;
-        }
-        else
+    // Probe and rank every stride-th move starting from the given one
+    auto rank_moves = [&](Position& p, size_t first, size_t stride) {
+
+        ProbeState result;
+        StateInfo st;
+        int dtz;
+
+        for (size_t i = first; i < rootMoves.size() && !failed; i += stride)
         {
-            // Otherwise, take dtz for the new position and correct by 1 ply
-            dtz = -probe_dtz(pos, &result);
-            dtz =  dtz > 0 ? dtz + 1
-                 : dtz < 0 ? dtz - 1 : dtz;
+            Search::RootMove& m = rootMoves[i];
+
+            p.do_move(m.pv[0], st);
+
+            // Calculate dtz for the current move counting from the root position
+            if (p.rule50_count() == 0)
+            {
+                // In case of a zeroing move, dtz is one of -101/-1/0/1/101
+                WDLScore wdl = -probe_wdl(p, &result);
+                dtz = dtz_before_zeroing(wdl);
+            }
+            else if (p.is_draw(1))
+            {
+                // In case a root move leads to a draw by repetition or
+                // 50-move rule, we set dtz to zero. Note: since we are
+                // only 1 ply from the root, this must be a true 3-fold
+                // repetition inside the game history.
+                dtz = 0;
+            }
+            else
+            {
+                // Otherwise, take dtz for the new position and correct by 1 ply
+                dtz = -probe_dtz(p, &result);
+                dtz =  dtz > 0 ? dtz + 1
+                     : dtz < 0 ? dtz - 1 : dtz;
+            }
+
+            // Make sure that a mating move is assigned a dtz value of 1
+            if (   p.checkers()
+                && dtz == 2
+                && MoveList<LEGAL>(p).size() == 0)
+                dtz = 1;
+
+            p.undo_move(m.pv[0]);
+
+            if (result == FAIL)
+            {
+                failed = true;
+                return;
+            }
+
+            // Better moves are ranked higher. Certain wins are ranked equally.
+            // Losing moves are ranked equally unless a 50-move draw is in sight.
+            int r =  dtz > 0 ? (dtz + cnt50 <= 99 && !rep ? 1000 : 1000 - (dtz + cnt50))
+                   : dtz < 0 ? (-dtz * 2 + cnt50 < 100 ? -1000 : -1000 + (-dtz + cnt50))
+                   : 0;
+            m.tbRank = r;
+
+            // Determine the score to be displayed for this move. Assign at least
+            // 1 cp to cursed wins and let it grow to 49 cp as the positions gets
+            // closer to a real win.
+            m.tbScore =  r >= bound ? VALUE_MATE - MAX_PLY - 1
+                       : r >  0     ? Value((std::max( 3, r - 800) * int(PawnValueEg)) / 200)
+                       : r == 0     ? VALUE_DRAW
+                       : r > -bound ? Value((std::min(-3, r + 800) * int(PawnValueEg)) / 200)
+                       :             -VALUE_MATE + MAX_PLY + 1;
         }
+    };
 
-        // Make sure that a mating move is assigned a dtz value of 1
-        if (   pos.checkers()
-            && dtz == 2
-            && MoveList<LEGAL>(pos).size() == 0)
-            dtz = 1;
+    // Probing may have to wait for the tables to be read from disk, so the
+    // moves are split across the idle search threads, each probing on its own
+    // root position. The calling thread takes the first share on 'pos'.
+    const size_t threadCount = std::min(Threads.size(), rootMoves.size());
 
-        pos.undo_move(m.pv[0]);
+    for (size_t idx = 1; idx < threadCount; ++idx)
+        Threads[idx]->run_custom_job([&, idx]() { rank_moves(Threads[idx]->rootPos, idx, threadCount); });
 
-        if (result == FAIL)
-            return false;
+    rank_moves(pos, 0, threadCount);
 
-        // Better moves are ranked higher. Certain wins are ranked equally.
-        // Losing moves are ranked equally unless a 50-move draw is in sight.
-        int r =  dtz > 0 ? (dtz + cnt50 <= 99 && !rep ? 1000 : 1000 - (dtz + cnt50))
-               : dtz < 0 ? (-dtz * 2 + cnt50 < 100 ? -1000 : -1000 + (-dtz + cnt50))
-               : 0;
-        m.tbRank = r;
-
-        // Determine the score to be displayed for this move. Assign at least
-        // 1 cp to cursed wins and let it grow to 49 cp as the positions gets
-        // closer to a real win.
-        m.tbScore =  r >= bound ? VALUE_MATE - MAX_PLY - 1
-                   : r >  0     ? Value((std::max( 3, r - 800) * int(PawnValueEg)) / 200)
-                   : r == 0     ? VALUE_DRAW
-                   : r > -bound ? Value((std::min(-3, r + 800) * int(PawnValueEg)) / 200)
-                   :             -VALUE_MATE + MAX_PLY + 1;
-    }
+    for (size_t idx = 1; idx < threadCount; ++idx)
+        Threads[idx]->wait_for_search_finished();
 
-    return true;
+    return !failed;
 }
 
 
@@ -20,6 +20,8 @@
 #define TBPROBE_H
 
 #include <ostream>
+#include <string>
+#include <vector>
 
 #include "../search.h"
 
@@ -51,6 +53,20 @@ int probe_dtz(Position& pos, ProbeState* result);
 bool root_probe(Position& pos, Search::RootMoves& rootMoves);
 bool root_probe_wdl(Position& pos, Search::RootMoves& rootMoves);
 void rank_root_moves(Position& pos, Search::RootMoves& rootMoves);
+void warm_up(const Position& pos, int cardinality);
+uint64_t stalls_avoided();
+
+// Tablebases of other variants are generated by the engine itself and store
+// the distance to mate in plies for small sets of pieces on the board.
+namespace Fairy {
+
+extern int MaxCardinality;
+
+void init(const std::string& paths);
+void generate(const std::vector<std::string>& materials, int maxPieces);
+Value probe(const Position& pos, int ply, ProbeState* result);
+
+} // namespace Fairy
 
 inline std::ostream& operator<<(std::ostream& os, const WDLScore v) {
 
@@ -39,6 +39,7 @@ ThreadPool Threads; // Global object
 Thread::Thread(size_t n) : idx(n), stdThread(&Thread::idle_loop, this) {
 
   wait_for_search_finished();
+  resize_eval_tables();
 }
 
 
@@ -64,6 +65,7 @@ void Thread::clear() {
   gateHistory.fill(0);
   lowPlyHistory.fill(0);
   captureHistory.fill(0);
+  counters = HotCounters();
 
   for (bool inCheck : { false, true })
       for (StatsType c : { NoCaptures, Captures })
@@ -76,6 +78,16 @@ void Thread::clear() {
 }
 
 
+/// Thread::resize_eval_tables() sizes the pawn and material hash tables as set
+/// by the "Pawn Hash" and "Material Hash" options, in kB per thread.
+
+void Thread::resize_eval_tables() {
+
+  pawnsTable.resize(size_t(Options["Pawn Hash"]) * 1024 / sizeof(Pawns::Entry));
+  materialTable.resize(size_t(Options["Material Hash"]) * 1024 / sizeof(Material::Entry));
+}
+
+
 /// Thread::start_searching() wakes up the thread that will start the search
 
 void Thread::start_searching() {
@@ -86,6 +98,19 @@ void Thread::start_searching() {
 }
 
 
+/// Thread::run_custom_job() wakes up the thread to run the given function
+/// instead of a search. Completion is waited for with wait_for_search_finished().
+
+void Thread::run_custom_job(std::function<void()> f) {
+
+  std::unique_lock<std::mutex> lk(mutex);
+  cv.wait(lk, [&]{ return !searching; });
+  jobFunc = std::move(f);
+  searching = true;
+  cv.notify_one(); // Wake up the thread in idle_loop()
+}
+
+
 /// Thread::wait_for_search_finished() blocks on the condition variable
 /// until the thread has finished searching.
 
@@ -125,9 +150,15 @@ void Thread::idle_loop() {
       if (exit)
           return;
 
+      std::function<void()> job = std::move(jobFunc);
+      jobFunc = nullptr;
+
       lk.unlock();
 
-      search();
+      if (job)
+          job();
+      else
+          search();
   }
 }
 
@@ -162,6 +193,18 @@ void ThreadPool::set(size_t requested) {
 }
 
 
+/// ThreadPool::resize_eval_tables() resizes the pawn and material hash tables
+/// of all threads.
+
+void ThreadPool::resize_eval_tables() {
+
+  main()->wait_for_search_finished();
+
+  for (Thread* th : *this)
+      th->resize_eval_tables();
+}
+
+
 /// ThreadPool::clear() sets threadPool data to initial values
 
 void ThreadPool::clear() {
@@ -183,6 +226,8 @@ void ThreadPool::start_thinking(Position& pos, StateListPtr& states,
 
   main()->wait_for_search_finished();
 
+  Search::read_settings();
+
   main()->stopOnPonderhit = stop = abort = false;
   increaseDepth = true;
   main()->ponder = ponderMode;
@@ -211,9 +256,6 @@ void ThreadPool::start_thinking(Position& pos, StateListPtr& states,
       }
   }
 
-  if (!rootMoves.empty())
-      Tablebases::rank_root_moves(pos, rootMoves);
-
   // After ownership transfer 'states' becomes empty, so if we stop the search
   // and call 'go' again without setting a new position states.get() == NULL.
   assert(states.get() || setupStates.get());
@@ -225,19 +267,59 @@ void ThreadPool::start_thinking(Position& pos, StateListPtr& states,
   // some StateInfo fields (previous, pliesFromNull, capturedPiece) that cannot
   // be deduced from a fen string, so set() clears them and they are set from
   // setupStates->back() later. The rootState is per thread, earlier states are shared
-  // since they are read-only.
+  // since they are read-only. Their chase sets are filled here for that reason.
+  if (pos.variant()->chasingRule)
+      pos.update_chased();
+
+  for (Thread* th : *this)
+  {
+      th->rootPos.set(pos.variant(), pos.fen(), pos.is_chess960(), &th->rootState, th);
+      th->rootState = setupStates->back();
+      th->rootPos.init_repetition_index(&th->repetitions);
+  }
+
+  // Tablebase probing at the root is shared by the idle threads, each on its rootPos
+  if (!rootMoves.empty())
+      Tablebases::rank_root_moves(pos, rootMoves);
+
   for (Thread* th : *this)
   {
       th->nodes = th->tbHits = th->nmpMinPly = th->bestMoveChanges = 0;
       th->rootDepth = th->completedDepth = 0;
+      th->ttStats = TTStats();
       th->rootMoves = rootMoves;
-      th->rootPos.set(pos.variant(), pos.fen(), pos.is_chess960(), &th->rootState, th);
-      th->rootState = setupStates->back();
   }
 
   main()->start_searching();
 }
 
+/// ThreadPool::tt_stats() sums the transposition table counters of all threads
+/// for the last search.
+
+TTStats ThreadPool::tt_stats() const {
+
+  TTStats sum = TTStats();
+  for (Thread* th : *this)
+  {
+      sum.probes     += th->ttStats.probes;
+      sum.hits       += th->ttStats.hits;
+      sum.collisions += th->ttStats.collisions;
+  }
+  return sum;
+}
+
+/// ThreadPool::hot_counters() sums the profiling counters of all threads since
+/// the last clear().
+
+HotCounters ThreadPool::hot_counters() const {
+
+  HotCounters sum = HotCounters();
+  for (Thread* th : *this)
+      for (int c = 0; c < HOT_COUNTER_NB; ++c)
+          sum.count[c] += th->counters.count[c];
+  return sum;
+}
+
 Thread* ThreadPool::get_best_thread() const {
 
     Thread* bestThread = front();
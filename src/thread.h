@@ -21,6 +21,7 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <functional>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -31,6 +32,7 @@
 #include "position.h"
 #include "search.h"
 #include "thread_win32_osx.h"
+#include "tt.h"
 
 namespace Stockfish {
 
@@ -45,6 +47,7 @@ class Thread {
   std::condition_variable cv;
   size_t idx;
   bool exit = false, searching = true; // Set before starting std::thread
+  std::function<void()> jobFunc;
   NativeThread stdThread;
 
 public:
@@ -52,8 +55,10 @@ public:
   virtual ~Thread();
   virtual void search();
   void clear();
+  void resize_eval_tables();
   void idle_loop();
   void start_searching();
+  void run_custom_job(std::function<void()> f);
   void wait_for_search_finished();
   size_t id() const { return idx; }
 
@@ -64,9 +69,12 @@ public:
   int selDepth, nmpMinPly;
   Color nmpColor;
   std::atomic<uint64_t> nodes, tbHits, bestMoveChanges;
+  TTStats ttStats;
+  HotCounters counters;
 
   Position rootPos;
   StateInfo rootState;
+  RepetitionIndex repetitions;
   Search::RootMoves rootMoves;
   Depth rootDepth, completedDepth;
   CounterMoveHistory counterMoves;
@@ -87,11 +95,14 @@ struct MainThread : public Thread {
 
   void search() override;
   void check_time();
+  bool info_due(bool force);
 
   double previousTimeReduction;
   Value bestPreviousScore;
   Value iterValue[4];
   int callsCnt;
+  int infoInterval;
+  TimePoint lastOutputTime;
   bool stopOnPonderhit;
   std::atomic_bool ponder;
   Thread* bestThread; // to fetch best move when in XBoard mode
@@ -107,10 +118,13 @@ struct ThreadPool : public std::vector<Thread*> {
   void start_thinking(Position&, StateListPtr&, const Search::LimitsType&, bool = false);
   void clear();
   void set(size_t);
+  void resize_eval_tables();
 
   MainThread* main()        const { return static_cast<MainThread*>(front()); }
   uint64_t nodes_searched() const { return accumulate(&Thread::nodes); }
   uint64_t tb_hits()        const { return accumulate(&Thread::tbHits); }
+  TTStats tt_stats() const;
+  HotCounters hot_counters() const;
   Thread* get_best_thread() const;
   void start_searching();
   void wait_for_search_finished() const;
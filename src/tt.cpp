@@ -63,6 +63,7 @@ void TTEntry::save(Key k, Value v, bool pv, Bound b, Depth d, Move m, Value ev)
 void TranspositionTable::resize(size_t mbSize) {
 
   Threads.main()->wait_for_search_finished();
+  wait_for_clear();
 
   aligned_large_pages_free(table);
 
@@ -80,25 +81,98 @@ void TranspositionTable::resize(size_t mbSize) {
 }
 
 
+/// TranspositionTable::set_wide_keys() switches between the default cluster
+/// layout and the wide one with 32-bit verification keys. Since both layouts
+/// interpret the cluster bytes differently, the table is zeroed before use.
+
+void TranspositionTable::set_wide_keys(bool wide) {
+
+  Threads.main()->wait_for_search_finished();
+  wait_for_clear();
+
+  wideKeys = wide;
+  zero(Options["Threads"]);
+}
+
+
 /// TranspositionTable::clear() initializes the entire transposition table to zero,
-//  in a multi-threaded way.
+/// in a multi-threaded way. Huge tables are zeroed in the background by a single
+/// thread under a new epoch, so that the table can be used right away. Epochs of
+/// background clears are never zero, which also makes the freshly mapped pages of
+/// a resized table stale.
 
 void TranspositionTable::clear() {
 
+  if (clusterCount * sizeof(Cluster) < ASYNC_CLEAR_SIZE)
+  {
+      zero(Options["Threads"]);
+      return;
+  }
+
+  std::lock_guard<std::mutex> lk(clearMutex);
+
+  clearEpoch = uint8_t(clearEpoch % 255 + 1);
+
+  // A running clear has to start over, since the clusters it has passed
+  // carry the previous epoch.
+  if (clearing)
+  {
+      clearAgain = true;
+      return;
+  }
+
+  if (clearThread.joinable())
+      clearThread.join();
+
+  clearing = true;
+  clearThread = std::thread([this]() {
+      while (true)
+      {
+          zero_in_background();
+
+          std::lock_guard<std::mutex> lk2(clearMutex);
+          if (!clearAgain)
+          {
+              clearing = false;
+              break;
+          }
+          clearAgain = false;
+      }
+  });
+}
+
+
+/// TranspositionTable::wait_for_clear() blocks until a background clear of
+/// the table, if any, has finished.
+
+void TranspositionTable::wait_for_clear() {
+
+  if (clearThread.joinable())
+      clearThread.join();
+}
+
+
+/// TranspositionTable::zero() sets the whole table to zero using the given
+/// number of threads. The zero epoch then marks all clusters as current.
+
+void TranspositionTable::zero(size_t threadCount) {
+
+  clearEpoch = 0;
+
   std::vector<std::thread> threads;
 
-  for (size_t idx = 0; idx < Options["Threads"]; ++idx)
+  for (size_t idx = 0; idx < threadCount; ++idx)
   {
-      threads.emplace_back([this, idx]() {
+      threads.emplace_back([this, idx, threadCount]() {
 
           // Thread binding gives faster search on systems with a first-touch policy
-          if (Options["Threads"] > 8)
+          if (threadCount > 8)
               WinProcGroup::bindThisThread(idx);
 
           // Each thread will zero its part of the hash table
-          const size_t stride = size_t(clusterCount / Options["Threads"]),
+          const size_t stride = size_t(clusterCount / threadCount),
                        start  = size_t(stride * idx),
-                       len    = idx != Options["Threads"] - 1 ?
+                       len    = idx != threadCount - 1 ?
                                 stride : clusterCount - start;
 
           std::memset(&table[start], 0, len * sizeof(Cluster));
@@ -110,6 +184,20 @@ void TranspositionTable::clear() {
 }
 
 
+/// TranspositionTable::zero_in_background() zeroes the table cluster by cluster
+/// and stamps each with the current epoch. A single thread is used so that the
+/// zeroing competes as little as possible with a running search.
+
+void TranspositionTable::zero_in_background() {
+
+  for (size_t i = 0; i < clusterCount; ++i)
+  {
+      std::memset(&table[i], 0, sizeof(Cluster));
+      table[i].epoch = clearEpoch.load(std::memory_order_relaxed);
+  }
+}
+
+
 /// TranspositionTable::probe() looks up the current position in the transposition
 /// table. It returns true and a pointer to the TTEntry if the position is found.
 /// Otherwise, it returns false and a pointer to an empty or least valuable TTEntry
@@ -117,30 +205,92 @@ void TranspositionTable::clear() {
 /// minus 8 times its relative age. TTEntry t1 is considered more valuable than
 /// TTEntry t2 if its replace value is greater than that of t2.
 
-TTEntry* TranspositionTable::probe(const Key key, bool& found) const {
+TTEntry* TranspositionTable::probe(const Key key, bool& found, TTStats& stats) const {
 
   TTEntry* const tte = first_entry(key);
   const uint16_t key16 = (uint16_t)key;  // Use the low 16 bits as key inside the cluster
+  const int clusterSize = cluster_size();
+
+  // The wide layout additionally verifies the next 16 bits of the key
+  uint16_t* const keyHi16 = wideKeys ? reinterpret_cast<WideCluster*>(tte)->keyHi16 : nullptr;
+  const uint16_t hi16 = (uint16_t)(key >> 16);
 
-  for (int i = 0; i < ClusterSize; ++i)
+  if (UseCounters)
+      ++stats.probes;
+
+  // While a background clear is running, clusters of an older epoch are empty
+  if (clearing.load(std::memory_order_relaxed))
+  {
+      Cluster* const cluster = reinterpret_cast<Cluster*>(tte);
+      const uint8_t epoch = clearEpoch.load(std::memory_order_relaxed);
+      if (cluster->epoch != epoch)
+      {
+          std::memset(cluster, 0, sizeof(Cluster));
+          cluster->epoch = epoch;
+      }
+  }
+
+  for (int i = 0; i < clusterSize; ++i)
       if (tte[i].key16 == key16 || !tte[i].depth8)
       {
+          if (keyHi16 && keyHi16[i] != hi16)
+          {
+              if (tte[i].depth8)
+              {
+                  if (UseCounters)
+                      ++stats.collisions;
+                  continue;
+              }
+              keyHi16[i] = hi16; // Claim the empty entry
+          }
+
           tte[i].genBound8 = uint8_t(generation8 | (tte[i].genBound8 & (GENERATION_DELTA - 1))); // Refresh
 
-          return found = (bool)tte[i].depth8, &tte[i];
+          found = (bool)tte[i].depth8;
+          if (UseCounters)
+              stats.hits += found;
+          return &tte[i];
       }
 
+  // Due to our packed storage format for generation and its cyclic nature we
+  // add GENERATION_CYCLE (256 is the modulus, plus what is needed to keep the
+  // unrelated lowest n bits from affecting the result) to calculate the entry
+  // age correctly even after generation8 overflows into the next cycle.
+  auto age = [&](const TTEntry* e) { return (GENERATION_CYCLE + generation8 - e->genBound8) & GENERATION_MASK; };
+
   // Find an entry to be replaced according to the replacement strategy
   TTEntry* replace = tte;
-  for (int i = 1; i < ClusterSize; ++i)
-      // Due to our packed storage format for generation and its cyclic
-      // nature we add GENERATION_CYCLE (256 is the modulus, plus what
-      // is needed to keep the unrelated lowest n bits from affecting
-      // the result) to calculate the entry age correctly even after
-      // generation8 overflows into the next cycle.
-      if (  replace->depth8 - ((GENERATION_CYCLE + generation8 - replace->genBound8) & GENERATION_MASK)
-          >   tte[i].depth8 - ((GENERATION_CYCLE + generation8 -   tte[i].genBound8) & GENERATION_MASK))
-          replace = &tte[i];
+  if (!keyHi16)
+  {
+      for (int i = 1; i < clusterSize; ++i)
+          if (replace->depth8 - age(replace) > tte[i].depth8 - age(&tte[i]))
+              replace = &tte[i];
+  }
+  else
+  {
+      // The wide layout replaces in two buckets. Entries left over from before
+      // the previous search go first, the shallowest of them. Only when there
+      // is none, the entries are compared by depth and age as usual.
+      TTEntry* stale = nullptr;
+      for (int i = 0; i < clusterSize; ++i)
+          if (   age(&tte[i]) > GENERATION_DELTA
+              && (!stale || tte[i].depth8 < stale->depth8))
+              stale = &tte[i];
+
+      if (stale)
+          replace = stale;
+      else
+          for (int i = 1; i < clusterSize; ++i)
+              if (replace->depth8 - age(replace) > tte[i].depth8 - age(&tte[i]))
+                  replace = &tte[i];
+
+      keyHi16[replace - tte] = hi16;
+
+      // TTEntry::save() only sees the low key bits, so an entry colliding on
+      // them must be emptied to not be mistaken for the same position.
+      if (replace->key16 == key16)
+          replace->depth8 = 0, replace->move32 = 0;
+  }
 
   return found = false, replace;
 }
@@ -151,12 +301,16 @@ TTEntry* TranspositionTable::probe(const Key key, bool& found) const {
 
 int TranspositionTable::hashfull() const {
 
+  const int clusterSize = cluster_size();
+  const uint8_t epoch = clearEpoch.load(std::memory_order_relaxed);
   int cnt = 0;
   for (int i = 0; i < 1000; ++i)
-      for (int j = 0; j < ClusterSize; ++j)
-          cnt += table[i].entry[j].depth8 && (table[i].entry[j].genBound8 & GENERATION_MASK) == generation8;
+      for (int j = 0; j < clusterSize; ++j)
+          cnt +=    table[i].epoch == epoch
+                 && table[i].entry[j].depth8
+                 && (table[i].entry[j].genBound8 & GENERATION_MASK) == generation8;
 
-  return cnt / ClusterSize;
+  return cnt / clusterSize;
 }
 
 } // namespace Stockfish
@@ -19,6 +19,11 @@
 #ifndef TT_H_INCLUDED
 #define TT_H_INCLUDED
 
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+
 #include "misc.h"
 #include "types.h"
 
@@ -57,11 +62,32 @@ private:
 };
 
 
+/// TTStats keeps per-thread counters of transposition table accesses. A
+/// collision is an entry whose 16 low key bits match but whose upper key bits
+/// do not, which is only detectable with the wide cluster layout. Like the hot
+/// path counters, they are only counted with USE_COUNTERS.
+
+struct TTStats {
+  uint64_t probes, hits, collisions;
+};
+
+
 /// A TranspositionTable is an array of Cluster, of size clusterCount. Each
 /// cluster consists of ClusterSize number of TTEntry. Each non-empty TTEntry
 /// contains information on exactly one position. The size of a Cluster should
 /// divide the size of a cache line for best performance, as the cacheline is
 /// prefetched when possible.
+///
+/// With the wide layout a cluster holds one entry less and uses the freed
+/// bytes to store the upper 16 bits of a 32-bit verification key for each
+/// entry, trading capacity for fewer false hits on huge search trees. Its
+/// replacement first evicts the shallowest entry left from before the previous
+/// search, and only otherwise weighs depth against age.
+///
+/// Huge tables are zeroed in the background so that ucinewgame and resizing
+/// do not stall. Each clear gets a new epoch, which is stored in the last byte
+/// of every cluster as it is zeroed. Until the zeroing is done, probe() empties
+/// the clusters of older epochs it comes across.
 
 class TranspositionTable {
 
@@ -69,10 +95,22 @@ class TranspositionTable {
 
   struct Cluster {
     TTEntry entry[ClusterSize];
-    char padding[4]; // Pad to 64 bytes
+    char padding[3]; // Pad to 64 bytes
+    uint8_t epoch;
+  };
+
+  static constexpr int WideClusterSize = 4;
+
+  struct WideCluster {
+    TTEntry entry[WideClusterSize];
+    uint16_t keyHi16[WideClusterSize];
+    char padding[7]; // Pad to 64 bytes
+    uint8_t epoch;
   };
 
   static_assert(sizeof(Cluster) == 64, "Unexpected Cluster size");
+  static_assert(sizeof(WideCluster) == 64, "Unexpected WideCluster size");
+  static_assert(offsetof(Cluster, epoch) == offsetof(WideCluster, epoch), "Unexpected epoch offset");
 
   // Constants used to refresh the hash table periodically
   static constexpr unsigned GENERATION_BITS  = 3;                                // nb of bits reserved for other things
@@ -80,13 +118,18 @@ class TranspositionTable {
   static constexpr int      GENERATION_CYCLE = 255 + (1 << GENERATION_BITS);     // cycle length
   static constexpr int      GENERATION_MASK  = (0xFF << GENERATION_BITS) & 0xFF; // mask to pull out generation number
 
+  // Tables of at least this size are zeroed in the background
+  static constexpr size_t ASYNC_CLEAR_SIZE = size_t(1) << 30;
+
 public:
- ~TranspositionTable() { aligned_large_pages_free(table); }
+ ~TranspositionTable() { wait_for_clear(); aligned_large_pages_free(table); }
   void new_search() { generation8 += GENERATION_DELTA; } // Lower bits are used for other things
-  TTEntry* probe(const Key key, bool& found) const;
+  TTEntry* probe(const Key key, bool& found, TTStats& stats) const;
   int hashfull() const;
   void resize(size_t mbSize);
+  void set_wide_keys(bool wide);
   void clear();
+  void wait_for_clear();
 
   TTEntry* first_entry(const Key key) const {
     return &table[mul_hi64(key, clusterCount)].entry[0];
@@ -95,9 +138,19 @@ public:
 private:
   friend struct TTEntry;
 
+  int cluster_size() const { return wideKeys ? WideClusterSize : ClusterSize; }
+  void zero(size_t threadCount);
+  void zero_in_background();
+
   size_t clusterCount;
   Cluster* table;
+  bool wideKeys = false;
   uint8_t generation8; // Size must be not bigger than TTEntry::genBound8
+  std::atomic<uint8_t> clearEpoch;
+  std::atomic<bool> clearing;
+  bool clearAgain;
+  std::mutex clearMutex;
+  std::thread clearThread;
 };
 
 extern TranspositionTable TT;
@@ -19,6 +19,7 @@
 #include <cstdlib>
 #include <cassert>
 #include <cmath>
+#include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <string>
@@ -38,7 +39,7 @@ using namespace std;
 
 namespace Stockfish {
 
-extern vector<string> setup_bench(const Position&, istream&);
+extern vector<string> setup_bench(const Position&, istream&, string&);
 
 namespace {
 
@@ -93,6 +94,35 @@ namespace {
   }
 
 
+  // stats() prints the tablebase stalls avoided by warming them up and, when
+  // the counters are compiled in, the transposition table statistics of the
+  // last search and the hot path counters accumulated since the last "ucinewgame".
+
+  void stats() {
+
+    stringstream ss;
+
+    ss << left << setw(22) << "TB stalls avoided" << ": " << Tablebases::stalls_avoided();
+
+    if (UseCounters)
+    {
+        TTStats tt = Threads.tt_stats();
+        ss << "\n" << setw(22) << "TT probes"     << ": " << tt.probes
+           << "\n" << setw(22) << "TT hits"       << ": " << tt.hits
+           << " (" << fixed << setprecision(1) << 100.0 * tt.hits / std::max(tt.probes, uint64_t(1)) << "%)"
+           << "\n" << setw(22) << "TT collisions" << ": " << tt.collisions;
+
+        HotCounters counters = Threads.hot_counters();
+        for (int c = 0; c < HOT_COUNTER_NB; ++c)
+            ss << "\n" << setw(22) << hot_counter_name(HotCounter(c)) << ": " << counters.count[c];
+    }
+    else
+        ss << "\nHot path counters are not compiled in, rebuild with counters=yes";
+
+    sync_cout << ss.str() << sync_endl;
+  }
+
+
   // setoption() is called when engine receives the "setoption" UCI command. The
   // function updates the UCI option ("name") to the given value ("value").
 
@@ -174,16 +204,43 @@ namespace {
     Threads.start_thinking(pos, states, limits, ponderMode);
   }
 
+  // mean_stddev() returns the mean and the sample standard deviation of a
+  // list of measurements.
+
+  pair<double, double> mean_stddev(const vector<double>& v) {
+
+    double sum = 0, sq = 0;
+    for (double x : v)
+        sum += x;
+    double mean = sum / std::max(v.size(), size_t(1));
+    for (double x : v)
+        sq += (x - mean) * (x - mean);
+    return { mean, v.size() > 1 ? std::sqrt(sq / (v.size() - 1)) : 0.0 };
+  }
+
+
   // bench() is called when engine receives the "bench" command. Firstly
   // a list of UCI commands is setup according to bench parameters, then
-  // it is run one by one printing a summary at the end.
+  // it is run one by one printing a summary at the end. With json or csv
+  // output, per position results over all runs are also printed to stdout.
 
   void bench(Position& pos, istream& args, StateListPtr& states) {
 
-    string token;
+    struct BenchResult {
+      string fen;
+      Depth depth;
+      int hashfull;
+      vector<double> nodes, time, nps;
+    };
+
+    string token, output;
     uint64_t num, nodes = 0, cnt = 1;
+    TTStats ttStats = TTStats();
+    vector<BenchResult> results;
+    vector<double> runNodes, runTime;
+    size_t runs = 0, goIdx = 0;
 
-    vector<string> list = setup_bench(pos, args);
+    vector<string> list = setup_bench(pos, args, output);
     num = count_if(list.begin(), list.end(), [](string s) { return s.find("go ") == 0 || s.find("eval") == 0; });
 
     TimePoint elapsed = now();
@@ -198,16 +255,44 @@ namespace {
             cerr << "\nPosition: " << cnt++ << '/' << num << " (" << pos.fen() << ")" << endl;
             if (token == "go")
             {
+               string fen = pos.fen();
+               TimePoint start = now();
                go(pos, is, states);
                Threads.main()->wait_for_search_finished();
+               double time = double(std::max(now() - start, TimePoint(1)));
                nodes += Threads.nodes_searched();
+               TTStats s = Threads.tt_stats();
+               ttStats.probes += s.probes, ttStats.hits += s.hits, ttStats.collisions += s.collisions;
+
+               // Positions are searched in the same order in every run
+               if (goIdx == results.size())
+                   results.push_back({ fen, 0, 0, {}, {}, {} });
+               BenchResult& r = results[goIdx++];
+               r.depth = Threads.get_best_thread()->completedDepth;
+               r.hashfull = TT.hashfull();
+               r.nodes.push_back(double(Threads.nodes_searched()));
+               r.time.push_back(time);
+               r.nps.push_back(1000 * r.nodes.back() / time);
+               runNodes.back() += r.nodes.back();
+               runTime.back() += time;
             }
             else
                trace_eval(pos);
         }
         else if (token == "setoption")  setoption(is);
         else if (token == "position")   position(pos, is, states);
-        else if (token == "ucinewgame") { Search::clear(); elapsed = now(); } // Search::clear() may take some while
+        else if (token == "ucinewgame")
+        {
+            // Search::clear() may take some while, so it is not timed. All
+            // bitbases of the variant are built first to get reproducible results.
+            TimePoint clearStart = now();
+            Search::clear();
+            Bitbases::wait();
+            elapsed = runs++ ? elapsed + now() - clearStart : now();
+            runNodes.push_back(0);
+            runTime.push_back(0);
+            goIdx = 0;
+        }
     }
 
     elapsed = now() - elapsed + 1; // Ensure positivity to avoid a 'divide by zero'
@@ -218,6 +303,68 @@ namespace {
          << "\nTotal time (ms) : " << elapsed
          << "\nNodes searched  : " << nodes
          << "\nNodes/second    : " << 1000 * nodes / elapsed << endl;
+
+    if (UseCounters)
+        cerr << "TT probes       : " << ttStats.probes
+             << "\nTT hits         : " << ttStats.hits
+             << "\nTT collisions   : " << ttStats.collisions << endl;
+
+    if (output != "json" && output != "csv")
+        return;
+
+    vector<double> runNps;
+    for (size_t i = 0; i < runNodes.size(); ++i)
+        runNps.push_back(1000 * runNodes[i] / std::max(runTime[i], 1.0));
+
+    stringstream ss;
+    ss << fixed << setprecision(2);
+
+    if (output == "json")
+    {
+        auto stat = [&](const string& name, const vector<double>& v) {
+            pair<double, double> ms = mean_stddev(v);
+            ss << ",\"" << name << "_mean\":" << ms.first << ",\"" << name << "_stddev\":" << ms.second;
+        };
+
+        ss << "{\"variant\":\"" << string(Options["UCI_Variant"]) << "\",\"positions\":[";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const BenchResult& r = results[i];
+            ss << (i ? "," : "") << "{\"fen\":\"" << r.fen << "\",\"depth\":" << r.depth << ",\"hashfull\":" << r.hashfull;
+            stat("nodes", r.nodes);
+            stat("time", r.time);
+            stat("nps", r.nps);
+            ss << "}";
+        }
+        ss << "],\"total\":{\"runs\":" << runs;
+        stat("nodes", runNodes);
+        stat("time", runTime);
+        stat("nps", runNps);
+        ss << "}}";
+    }
+    else
+    {
+        auto stat = [&](const vector<double>& v) {
+            pair<double, double> ms = mean_stddev(v);
+            ss << "," << ms.first << "," << ms.second;
+        };
+
+        ss << "position,fen,depth,hashfull,nodes_mean,nodes_stddev,time_mean,time_stddev,nps_mean,nps_stddev";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const BenchResult& r = results[i];
+            ss << "\n" << i + 1 << ",\"" << r.fen << "\"," << r.depth << "," << r.hashfull;
+            stat(r.nodes);
+            stat(r.time);
+            stat(r.nps);
+        }
+        ss << "\ntotal,,,";
+        stat(runNodes);
+        stat(runTime);
+        stat(runNps);
+    }
+
+    sync_cout << ss.str() << sync_endl;
   }
 
   // The win rate model returns the probability (per mille) of winning given an eval
@@ -242,6 +389,26 @@ namespace {
      return int(0.5 + 1000 / (1 + std::exp((a - x) / b)));
   }
 
+  // tbgen() is called when engine receives the "tbgen" command. The arguments
+  // are either the maximum number of pieces (3 by default) or a list of material
+  // signatures like KRvK, and tables are generated for the current variant.
+
+  void tbgen(istringstream& is) {
+
+    int maxPieces = 3;
+    vector<string> materials;
+    string token;
+
+    while (is >> token)
+        if (isdigit(token[0]))
+            maxPieces = stoi(token);
+        else
+            materials.push_back(token);
+
+    Threads.main()->wait_for_search_finished();
+    Tablebases::Fairy::generate(materials, maxPieces);
+  }
+
   // load() is called when engine receives the "load" or "check" command.
   // The function reads variant configuration files.
 
@@ -390,6 +557,8 @@ void UCI::loop(int argc, char* argv[]) {
       else if (token == "d")        sync_cout << pos << sync_endl;
       else if (token == "eval")     trace_eval(pos);
       else if (token == "compiler") sync_cout << compiler_info() << sync_endl;
+      else if (token == "stats")    stats();
+      else if (token == "tbgen")    tbgen(is);
       else if (token == "export_net")
       {
           std::optional<std::string> filename;
@@ -22,6 +22,7 @@
 #include <sstream>
 #include <iostream>
 
+#include "endgame.h"
 #include "evaluate.h"
 #include "misc.h"
 #include "piece.h"
@@ -60,9 +61,12 @@ void init_variant(const Variant* v) {
 /// 'On change' actions, triggered by an option's value change
 void on_clear_hash(const Option&) { Search::clear(); }
 void on_hash_size(const Option& o) { TT.resize(size_t(o)); }
+void on_hash_layout(const Option& o) { TT.set_wide_keys(o == "wide"); }
 void on_logger(const Option& o) { start_logger(o); }
 void on_threads(const Option& o) { Threads.set(size_t(o)); }
+void on_eval_hash(const Option&) { Threads.resize_eval_tables(); }
 void on_tb_path(const Option& o) { Tablebases::init(o); }
+void on_settings(const Option& ) { Search::read_settings(); }
 
 void on_use_NNUE(const Option& ) { Eval::NNUE::init(); }
 void on_eval_file(const Option& ) { Eval::NNUE::init(); }
@@ -80,9 +84,16 @@ void on_variant_set(const Option &o) {
     // Re-initialize NNUE
     Eval::NNUE::init();
 
+    // Stop building bitbases before the attack tables are changed
+    Bitbases::clear();
+
     const Variant* v = variants.find(o)->second;
     init_variant(v);
     PSQT::init(v);
+    Bitbases::init(v);
+    Endgames::init(v);
+    Search::read_settings();
+    Tablebases::Fairy::init(Options["SyzygyPath"]);
 }
 void on_variant_change(const Option &o) {
     // Variant initialization
@@ -184,8 +195,12 @@ void init(OptionsMap& o) {
   o["Threads"]               << Option(1, 1, 512, on_threads);
   o["Hash"]                  << Option(16, 1, MaxHashMB, on_hash_size);
   o["Clear Hash"]            << Option(on_clear_hash);
+  o["Hash Layout"]           << Option("compact", {"compact", "wide"}, on_hash_layout);
+  o["Pawn Hash"]             << Option(Pawns::Table::DefaultSize * sizeof(Pawns::Entry) / 1024, 1, 1 << 20, on_eval_hash);
+  o["Material Hash"]         << Option(Material::Table::DefaultSize * sizeof(Material::Entry) / 1024, 1, 1 << 20, on_eval_hash);
   o["Ponder"]                << Option(false);
   o["MultiPV"]               << Option(1, 1, 500);
+  o["Info Interval"]         << Option(0, 0, 60000);
   o["Skill Level"]           << Option(20, -20, 20);
   o["Move Overhead"]         << Option(10, 0, 5000);
   o["Slow Mover"]            << Option(100, 10, 1000);
@@ -200,13 +215,14 @@ void init(OptionsMap& o) {
   o["SyzygyProbeDepth"]      << Option(1, 1, 100);
   o["Syzygy50MoveRule"]      << Option(true);
   o["SyzygyProbeLimit"]      << Option(7, 0, 7);
+  o["SyzygyWarmup"]          << Option(false);
   o["Use NNUE"]              << Option(true, on_use_NNUE);
 #ifndef NNUE_EMBEDDING_OFF
   o["EvalFile"]              << Option(EvalFileDefaultName, on_eval_file);
 #else
   o["EvalFile"]              << Option("<empty>", on_eval_file);
 #endif
-  o["TsumeMode"]             << Option(false);
+  o["TsumeMode"]             << Option(false, on_settings);
   o["VariantPath"]           << Option("<empty>", on_variant_path);
   o["usemillisec"]           << Option(true); // time unit for UCCI
 }
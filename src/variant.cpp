@@ -2007,6 +2007,9 @@ void VariantMap::init() {
 
 // Pre-calculate derived properties
 Variant* Variant::conclude() {
+    // Piece-square tables of a template variant do not apply to this one
+    psqTable.reset();
+
     // Enforce consistency to allow runtime optimizations
     if (!doubleStep)
         doubleStepRegion[WHITE] = doubleStepRegion[BLACK] = 0;
@@ -2031,6 +2034,26 @@ Variant* Variant::conclude() {
                   && !restrictedMobility
                   && !cambodianMoves
                   && !diagonalLines;
+    // Without special legality rules, moves when not in check only need a pin test,
+    // which is exact for plain sliders and leapers
+    fastLegality =  !(pieceTypes & ~(CHESS_PIECES | COMMON_FAIRY_PIECES | SHOGI_PIECES | COMMON_STEP_PIECES))
+                  && kingType == KING
+                  && !restrictedMobility
+                  && !cambodianMoves
+                  && !diagonalLines
+                  && checking
+                  && dropChecks
+                  && !sittuyinPromotion
+                  && !mustCapture
+                  && !mustDrop
+                  && !dropOppositeColoredBishop
+                  && std::none_of(std::begin(isPriorityDrop), std::end(isPriorityDrop), [](bool b) { return b; })
+                  && multimoves.empty()
+                  && !dupleCheck
+                  && !mutuallyImmuneTypes
+                  && !flyingGeneral
+                  && !bikjangRule
+                  && !makpongRule;
 
     // Initialize calculated NNUE properties
     nnueKing =  pieceTypes & KING ? KING
@@ -2077,6 +2100,15 @@ Variant* Variant::conclude() {
         i++;
     }
 
+    // Dense indices of piece types into the attack tables of the classical evaluation.
+    // Index 0 is for all pieces and index 1 is shared by the piece types the
+    // variant does not have, so it stays empty. King and pawn attacks are always set.
+    attackIndexCount = 2;
+    std::fill(std::begin(attackIndex), std::end(attackIndex), 1);
+    attackIndex[ALL_PIECES] = 0;
+    for (PieceSet ps = pieceTypes | KING | PAWN | SHOGI_PAWN; ps;)
+        attackIndex[pop_lsb(ps)] = attackIndexCount++;
+
     // Map king squares to enumeration of actually available squares.
     // E.g., for xiangqi map from 0-89 to 0-8.
     // Variants might be initialized before bitboards, so do not rely on precomputed bitboards (like SquareBB).
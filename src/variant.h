@@ -20,6 +20,7 @@
 #define VARIANT_H_INCLUDED
 
 #include <bitset>
+#include <memory>
 #include <set>
 #include <map>
 #include <vector>
@@ -33,6 +34,8 @@
 
 namespace Stockfish {
 
+namespace PSQT { struct Table; }
+
 /// Variant struct stores information needed to determine the rules of a variant.
 
 constexpr int START_MULTIMOVES = 16;
@@ -188,6 +191,7 @@ struct Variant {
   // Derived properties
   bool fastAttacks = true;
   bool fastAttacks2 = true;
+  bool fastLegality = false;
   std::string nnueAlias = "";
   PieceType nnueKing = KING;
   int nnueDimensions;
@@ -196,6 +200,8 @@ struct Variant {
   int pieceHandIndex[COLOR_NB][PIECE_NB];
   int kingSquareIndex[SQUARE_NB];
   int nnueMaxPieces;
+  int attackIndex[PIECE_TYPE_NB];
+  int attackIndexCount;
   EndgameEval endgameEval = EG_EVAL_CHESS;
   bool shogiStylePromotions = false;
   std::vector<Direction> connect_directions;
@@ -204,6 +210,7 @@ struct Variant {
   int multimoveOffset; // end of multimoveStart sequence
   int multimoveCycle; // length in ply of both players once playing a multimove
   int multimoveCycleShift; // phase shift in multimove cycle when switching color
+  mutable std::shared_ptr<const PSQT::Table> psqTable; // computed at first use by PSQT::table()
 
   void add_piece(PieceType pt, char c, std::string betza = "", char c2 = ' ') {
       // Avoid ambiguous definition by removing existing piece with same letter